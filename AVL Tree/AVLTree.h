@@ -0,0 +1,1083 @@
+#ifndef AVL_TREE_H
+#define AVL_TREE_H
+
+#include <algorithm>
+#include <string>
+#include <queue>
+#include <cstring>
+#include <vector>
+#include <climits>
+
+#include "../Common/Stats.h"
+#include "../Common/JsonWriter.h"
+
+// Counter set the STAT_* macros below bump (Common/Stats.h)
+#undef STATS_MODULE
+#define STATS_MODULE STATS_AVL
+
+using namespace std;
+
+// --- AVL Logic ---
+
+// Nodes live in one NodePool and refer to each other by 32-bit index.
+// Index 0 is a shared sentinel with height 0, so NIL children need no null checks.
+static const int NIL = 0;
+
+// Root-to-leaf path bound for the iterative operations. An AVL tree of height h
+// has at least F(h + 2) - 1 nodes, so 64 levels covers any int-indexed pool.
+static const int MAX_PATH = 64;
+
+struct Node
+{
+    int key;
+    int left;
+    int right;
+    int height;
+    int size; // Nodes in this subtree, for rank / select
+};
+
+// Contiguous node storage with a free list. Indices stay valid when the array
+// grows; Node references do not, so never hold one across alloc().
+// reset() drops every node at once instead of walking the tree.
+class NodePool
+{
+private:
+    Node *nodes;
+    int count;
+    int capacity;
+    int freeList;
+
+    void growTo(int newCapacity)
+    {
+        Node *grown = new Node[newCapacity];
+        STAT_ALLOC(newCapacity * sizeof(Node));
+        memcpy(grown, nodes, count * sizeof(Node));
+        delete[] nodes;
+        nodes = grown;
+        capacity = newCapacity;
+    }
+
+public:
+    NodePool()
+    {
+        capacity = 64;
+        nodes = new Node[capacity];
+        STAT_ALLOC(capacity * sizeof(Node));
+        reset();
+    }
+
+    ~NodePool()
+    {
+        delete[] nodes;
+    }
+
+    int alloc(int key)
+    {
+        int n;
+        if (freeList != NIL)
+        {
+            n = freeList;
+            freeList = nodes[n].left;
+        }
+        else
+        {
+            if (count == capacity)
+                growTo(capacity * 2);
+            n = count++;
+        }
+        nodes[n].key = key;
+        nodes[n].left = NIL;
+        nodes[n].right = NIL;
+        nodes[n].height = 1;
+        nodes[n].size = 1;
+        return n;
+    }
+
+    void release(int n)
+    {
+        nodes[n].left = freeList;
+        freeList = n;
+    }
+
+    // Makes room for n more nodes up front (bulk builds)
+    void reserve(int n)
+    {
+        if (n > 0 && count + n > capacity)
+            growTo(count + n > capacity * 2 ? count + n : capacity * 2);
+    }
+
+    void reset()
+    {
+        nodes[NIL].key = 0;
+        nodes[NIL].left = nodes[NIL].right = NIL;
+        nodes[NIL].height = 0;
+        nodes[NIL].size = 0;
+        count = 1;
+        freeList = NIL;
+    }
+
+    Node &operator[](int n) { return nodes[n]; }
+
+    // Every index handed out so far is below this
+    int getCapacity() { return capacity; }
+};
+
+// Lookups interleaved per batch round in searchFrozenBatch
+static const int FROZEN_BATCH = 8;
+
+// Events recorded by insertKeyTraced/removeKeyTraced. JS maps these back to names
+// (keep in sync with AVL Tree/script.js).
+enum TraceEventType
+{
+    EV_VISIT = 0,        // Passed key on the way down; value = depth
+    EV_INSERTED = 1,     // New leaf key; value = depth
+    EV_DUPLICATE = 2,    // Insert found key already present
+    EV_NOT_FOUND = 3,    // Delete ran off the tree looking for key
+    EV_REPLACED = 4,     // Two-child delete: key's node now holds value (its successor)
+    EV_REMOVED = 5,      // Node holding key was unlinked; value = its depth
+    EV_HEIGHT = 6,       // key's height changed to value
+    EV_ROTATE_LEFT = 7,  // Left rotation at pivot key; value = the subtree's new root
+    EV_ROTATE_RIGHT = 8  // Right rotation at pivot key; value = the subtree's new root
+};
+
+// One event, laid out as three int32s so JS can read the trace straight out of
+// HEAP32 without any parsing
+struct TraceEvent
+{
+    int type;
+    int key;
+    int value;
+};
+
+// Subtrees of at most this many nodes keep their serialized JSON between calls
+static const int JSON_FRAGMENT_NODES = 64;
+
+class AVLTree
+{
+    NodePool pool;
+    int root;
+
+    // Read-only snapshot in Eytzinger (BFS) order: frozen[1] is the median, the
+    // children of slot k are 2k and 2k + 1. Cleared by every mutation.
+    vector<int> frozen;
+    int frozenCount;
+    bool frozenValid;
+
+    // Cached getJSON() output per small subtree, by node index ("" = stale).
+    // Anything that changes a subtree also goes through updateNode() or the size
+    // bump in retrace() for every ancestor, and both drop the ancestor's fragment.
+    vector<string> fragments;
+
+    // Events of the last traced insert/delete. Cleared (not freed) per operation,
+    // and only filled while tracing is set, so untraced calls pay one branch.
+    vector<TraceEvent> trace;
+    bool tracing;
+
+    void logEvent(TraceEventType type, int key, int value)
+    {
+        if (!tracing)
+            return;
+        TraceEvent e;
+        e.type = type;
+        e.key = key;
+        e.value = value;
+        trace.push_back(e);
+    }
+
+    void dropFragment(int n)
+    {
+        if (n < (int)fragments.size())
+            fragments[n].clear();
+    }
+
+    // pool.alloc plus dropping whatever the recycled index had cached
+    int newNode(int key)
+    {
+        int n = pool.alloc(key);
+        dropFragment(n);
+        return n;
+    }
+
+    int height(int n) { return pool[n].height; }
+    int max(int a, int b) { return (a > b) ? a : b; }
+
+    int subtreeSize(int n) { return pool[n].size; }
+
+    // Recomputes n's height and subtree size from its children
+    void updateNode(int n)
+    {
+        dropFragment(n);
+        int oldHeight = pool[n].height;
+        pool[n].height = max(height(pool[n].left), height(pool[n].right)) + 1;
+        pool[n].size = subtreeSize(pool[n].left) + subtreeSize(pool[n].right) + 1;
+        if (tracing && pool[n].height != oldHeight)
+            logEvent(EV_HEIGHT, pool[n].key, pool[n].height);
+    }
+
+    int rightRotate(int y)
+    {
+        int x = pool[y].left;
+        int T2 = pool[x].right;
+        logEvent(EV_ROTATE_RIGHT, pool[y].key, pool[x].key);
+        STAT_INC(STAT_ROTATIONS);
+        pool[x].right = y;
+        pool[y].left = T2;
+        updateNode(y);
+        updateNode(x);
+        return x;
+    }
+
+    int leftRotate(int x)
+    {
+        int y = pool[x].right;
+        int T2 = pool[y].left;
+        logEvent(EV_ROTATE_LEFT, pool[x].key, pool[y].key);
+        STAT_INC(STAT_ROTATIONS);
+        pool[y].left = x;
+        pool[x].right = T2;
+        updateNode(x);
+        updateNode(y);
+        return y;
+    }
+
+    int getBalance(int n) { return n != NIL ? height(pool[n].left) - height(pool[n].right) : 0; }
+
+    // Restores the AVL property at n (|balance| <= 1 below it) and returns the new
+    // subtree root. A zero-balance child takes the single rotation, as in delete.
+    int rebalance(int n)
+    {
+        int balance = getBalance(n);
+        if (balance > 1)
+        {
+            if (getBalance(pool[n].left) < 0)
+                pool[n].left = leftRotate(pool[n].left);
+            return rightRotate(n);
+        }
+        if (balance < -1)
+        {
+            if (getBalance(pool[n].right) > 0)
+                pool[n].right = rightRotate(pool[n].right);
+            return leftRotate(n);
+        }
+        return n;
+    }
+
+    // Points whichever link held oldChild (parent's, or root for depth 0) at newChild
+    void replaceChild(int *path, int depth, int oldChild, int newChild)
+    {
+        if (depth == 0)
+        {
+            root = newChild;
+            return;
+        }
+        int parent = path[depth - 1];
+        if (pool[parent].left == oldChild)
+            pool[parent].left = newChild;
+        else
+            pool[parent].right = newChild;
+    }
+
+    // Walks the recorded path bottom-up fixing heights and rotating where needed.
+    // Rebalancing stops as soon as a subtree's height comes out unchanged, since no
+    // height above it can have changed either; the ancestors only get their sizes
+    // bumped by delta (+1 insert, -1 delete).
+    void retrace(int *path, int depth, int delta)
+    {
+        int i = depth - 1;
+        for (; i >= 0; i--)
+        {
+            int n = path[i];
+            int oldHeight = height(n);
+            updateNode(n);
+            int sub = rebalance(n);
+            if (sub != n)
+                replaceChild(path, i, n, sub);
+            if (height(sub) == oldHeight)
+                break;
+        }
+        for (i--; i >= 0; i--)
+        {
+            pool[path[i]].size += delta;
+            dropFragment(path[i]);
+        }
+    }
+
+    bool insert(int key)
+    {
+        int path[MAX_PATH];
+        int depth = 0;
+        int n = root;
+        while (n != NIL)
+        {
+            if (key == pool[n].key)
+            {
+                logEvent(EV_DUPLICATE, key, depth);
+                return false;
+            }
+            logEvent(EV_VISIT, pool[n].key, depth);
+            path[depth++] = n;
+            n = key < pool[n].key ? pool[n].left : pool[n].right;
+        }
+
+        int leaf = newNode(key);
+        logEvent(EV_INSERTED, key, depth);
+        if (depth == 0)
+            root = leaf;
+        else if (key < pool[path[depth - 1]].key)
+            pool[path[depth - 1]].left = leaf;
+        else
+            pool[path[depth - 1]].right = leaf;
+        retrace(path, depth, 1);
+        return true;
+    }
+
+    bool remove(int key)
+    {
+        int path[MAX_PATH];
+        int depth = 0;
+        int n = root;
+        while (n != NIL && pool[n].key != key)
+        {
+            logEvent(EV_VISIT, pool[n].key, depth);
+            path[depth++] = n;
+            n = key < pool[n].key ? pool[n].left : pool[n].right;
+        }
+        if (n == NIL)
+        {
+            logEvent(EV_NOT_FOUND, key, depth);
+            return false;
+        }
+        logEvent(EV_VISIT, key, depth);
+        path[depth++] = n;
+
+        // Two children: take the in-order successor's key and unlink the successor
+        if (pool[n].left != NIL && pool[n].right != NIL)
+        {
+            int s = pool[n].right;
+            while (s != NIL)
+            {
+                logEvent(EV_VISIT, pool[s].key, depth);
+                path[depth++] = s;
+                s = pool[s].left;
+            }
+            // Logged in replay order: the successor's node goes, then key's node
+            // takes on the successor's key
+            int successorKey = pool[path[depth - 1]].key;
+            logEvent(EV_REMOVED, successorKey, depth - 1);
+            logEvent(EV_REPLACED, key, successorKey);
+            pool[n].key = successorKey;
+        }
+        else
+            logEvent(EV_REMOVED, key, depth - 1);
+
+        // path[depth - 1] now has at most one child, which takes its place
+        int victim = path[--depth];
+        int child = pool[victim].left != NIL ? pool[victim].left : pool[victim].right;
+        replaceChild(path, depth, victim, child);
+        pool.release(victim);
+        retrace(path, depth, -1);
+        return true;
+    }
+
+    bool search(int key)
+    {
+        int n = root;
+        while (n != NIL)
+        {
+            if (key == pool[n].key)
+                return true;
+            n = key < pool[n].key ? pool[n].left : pool[n].right;
+        }
+        return false;
+    }
+
+    // Appends the JSON for subtree n. The first small subtree on each root path
+    // comes from, or fills, the fragment cache. After a mutation, only the nodes
+    // above the fragments and the few stale fragments on the changed path get
+    // formatted again; everything else is a string copy. Only those topmost
+    // subtrees store a fragment (cache = false below them), so each key is
+    // cached about once.
+    void toJSON(int n, string &out, bool cache = true)
+    {
+        if (n == NIL)
+        {
+            out += "null";
+            return;
+        }
+        bool small = subtreeSize(n) <= JSON_FRAGMENT_NODES;
+        if (small && n < (int)fragments.size() && !fragments[n].empty())
+        {
+            out += fragments[n];
+            return;
+        }
+        if (!small || !cache)
+        {
+            writeNodeJSON(n, out, cache);
+            return;
+        }
+        if (n >= (int)fragments.size())
+            fragments.resize(pool.getCapacity());
+        writeNodeJSON(n, fragments[n], false);
+        out += fragments[n];
+    }
+
+    void writeNodeJSON(int n, string &out, bool cache)
+    {
+        out += "{\"value\":";
+        appendInt(out, pool[n].key);
+        out += ",\"height\":";
+        appendInt(out, pool[n].height);
+        out += ",\"children\":["; // D3 prefers 'children' array
+
+        // Always output two children for binary tree structure
+        toJSON(pool[n].left, out, cache);
+        out += ",";
+        toJSON(pool[n].right, out, cache);
+
+        out += "]}";
+    }
+
+    // --- Order statistics (subtree sizes) ---
+
+    // Number of keys < key, or <= key when inclusive
+    int countBelow(int key, bool inclusive)
+    {
+        int count = 0;
+        int n = root;
+        while (n != NIL)
+        {
+            if (key > pool[n].key || (inclusive && key == pool[n].key))
+            {
+                count += subtreeSize(pool[n].left) + 1;
+                n = pool[n].right;
+            }
+            else
+                n = pool[n].left;
+        }
+        return count;
+    }
+
+    // Node holding the k-th smallest key (0-based), NIL if out of range
+    int selectNode(int k)
+    {
+        if (k < 0 || k >= subtreeSize(root))
+            return NIL;
+        int n = root;
+        while (true)
+        {
+            int leftSize = subtreeSize(pool[n].left);
+            if (k < leftSize)
+                n = pool[n].left;
+            else if (k == leftSize)
+                return n;
+            else
+            {
+                k -= leftSize + 1;
+                n = pool[n].right;
+            }
+        }
+    }
+
+    // Writes up to max keys in [lo, hi] in ascending order; returns how many.
+    // In-order walk seeded with the path to lo, so it costs O(log n + written).
+    int collectRange(int lo, int hi, int *out, int max)
+    {
+        int stack[MAX_PATH];
+        int top = 0;
+        int n = root;
+        while (n != NIL)
+        {
+            if (pool[n].key >= lo)
+            {
+                stack[top++] = n;
+                n = pool[n].left;
+            }
+            else
+                n = pool[n].right;
+        }
+
+        int written = 0;
+        while (top > 0 && written < max)
+        {
+            n = stack[--top];
+            if (pool[n].key > hi)
+                break;
+            out[written++] = pool[n].key;
+            for (int c = pool[n].right; c != NIL; c = pool[c].left)
+                stack[top++] = c;
+        }
+        return written;
+    }
+
+    // --- Bulk build, join and split ---
+    // join/split follow Blelloch, Ferizovic and Sun, "Just Join for Parallel Ordered
+    // Sets" (2016). Subtree roots are passed by index within this tree's pool. The
+    // recursion depth is bounded by the tree height, like toJSON.
+
+    // Perfectly balanced subtree over vals[lo..hi], allocated in pre-order
+    int buildBalanced(const int *vals, int lo, int hi)
+    {
+        if (lo > hi)
+            return NIL;
+        int mid = lo + (hi - lo) / 2;
+        int n = newNode(vals[mid]);
+        int left = buildBalanced(vals, lo, mid - 1);
+        int right = buildBalanced(vals, mid + 1, hi);
+        pool[n].left = left;
+        pool[n].right = right;
+        updateNode(n);
+        return n;
+    }
+
+    int makeNode(int left, int k, int right)
+    {
+        pool[k].left = left;
+        pool[k].right = right;
+        updateNode(k);
+        return k;
+    }
+
+    // l is taller than r by 2 or more: walk down l's right spine to where r fits
+    int joinRight(int l, int k, int r)
+    {
+        int ll = pool[l].left;
+        int lr = pool[l].right;
+        if (height(lr) <= height(r) + 1)
+        {
+            int t = makeNode(lr, k, r);
+            if (height(t) <= height(ll) + 1)
+                return makeNode(ll, l, t);
+            return leftRotate(makeNode(ll, l, rightRotate(t)));
+        }
+        int t = joinRight(lr, k, r);
+        int t2 = makeNode(ll, l, t);
+        if (height(t) <= height(ll) + 1)
+            return t2;
+        return leftRotate(t2);
+    }
+
+    int joinLeft(int l, int k, int r)
+    {
+        int rl = pool[r].left;
+        int rr = pool[r].right;
+        if (height(rl) <= height(l) + 1)
+        {
+            int t = makeNode(l, k, rl);
+            if (height(t) <= height(rr) + 1)
+                return makeNode(t, r, rr);
+            return rightRotate(makeNode(leftRotate(t), r, rr));
+        }
+        int t = joinLeft(l, k, rl);
+        int t2 = makeNode(t, r, rr);
+        if (height(t) <= height(rr) + 1)
+            return t2;
+        return rightRotate(t2);
+    }
+
+    // Every key in l < pool[k].key < every key in r. O(|height(l) - height(r)|).
+    int join(int l, int k, int r)
+    {
+        if (height(l) > height(r) + 1)
+            return joinRight(l, k, r);
+        if (height(r) > height(l) + 1)
+            return joinLeft(l, k, r);
+        return makeNode(l, k, r);
+    }
+
+    // Splits t into keys < key (l) and keys > key (r). The node holding key itself,
+    // if any, is detached and returned through found (NIL otherwise). O(log n).
+    void split(int t, int key, int &l, int &found, int &r)
+    {
+        if (t == NIL)
+        {
+            l = r = found = NIL;
+            return;
+        }
+        int left = pool[t].left;
+        int right = pool[t].right;
+        if (key == pool[t].key)
+        {
+            l = left;
+            r = right;
+            found = t;
+        }
+        else if (key < pool[t].key)
+        {
+            int lr;
+            split(left, key, l, found, lr);
+            r = join(lr, t, right);
+        }
+        else
+        {
+            int rl;
+            split(right, key, rl, found, r);
+            l = join(left, t, rl);
+        }
+    }
+
+    // Detaches the largest node of t; rest receives what is left
+    int splitLast(int t, int &rest)
+    {
+        if (pool[t].right == NIL)
+        {
+            rest = pool[t].left;
+            return t;
+        }
+        int restRight;
+        int last = splitLast(pool[t].right, restRight);
+        rest = join(pool[t].left, t, restRight);
+        return last;
+    }
+
+    // join without a middle key: every key in l < every key in r
+    int join2(int l, int r)
+    {
+        if (l == NIL)
+            return r;
+        int rest;
+        int k = splitLast(l, rest);
+        return join(rest, k, r);
+    }
+
+    void releaseSubtree(int t)
+    {
+        if (t == NIL)
+            return;
+        int stack[MAX_PATH + 1];
+        int top = 0;
+        stack[top++] = t;
+        while (top > 0)
+        {
+            int n = stack[--top];
+            if (pool[n].right != NIL)
+                stack[top++] = pool[n].right;
+            if (pool[n].left != NIL)
+                stack[top++] = pool[n].left;
+            pool.release(n);
+        }
+    }
+
+    // Set union of two subtrees in one pool, O(m log(n/m + 1)) for sizes m <= n.
+    // Keys present in both keep a's node; b's copy is released.
+    int unionTrees(int a, int b)
+    {
+        if (a == NIL)
+            return b;
+        if (b == NIL)
+            return a;
+        int bl, found, br;
+        split(b, pool[a].key, bl, found, br);
+        if (found != NIL)
+            pool.release(found);
+        int left = unionTrees(pool[a].left, bl);
+        int right = unionTrees(pool[a].right, br);
+        return join(left, a, right);
+    }
+
+    // Set intersection, same bound. Nodes that drop out are released.
+    int intersectTrees(int a, int b)
+    {
+        if (a == NIL || b == NIL)
+        {
+            releaseSubtree(a);
+            releaseSubtree(b);
+            return NIL;
+        }
+        int bl, found, br;
+        split(b, pool[a].key, bl, found, br);
+        int aLeft = pool[a].left;
+        int aRight = pool[a].right;
+        int left = intersectTrees(aLeft, bl);
+        int right = intersectTrees(aRight, br);
+        if (found != NIL)
+        {
+            pool.release(found);
+            return join(left, a, right);
+        }
+        pool.release(a);
+        return join2(left, right);
+    }
+
+    // Tree over vals[0..n) in this pool. Input that is not strictly increasing is
+    // sorted and de-duplicated into a copy first.
+    int buildSubtree(const int *vals, int n)
+    {
+        if (!vals || n <= 0)
+            return NIL;
+        bool sorted = true;
+        for (int i = 1; i < n && sorted; i++)
+            sorted = vals[i - 1] < vals[i];
+
+        pool.reserve(n);
+        if (sorted)
+            return buildBalanced(vals, 0, n - 1);
+
+        std::vector<int> keys(vals, vals + n);
+        std::sort(keys.begin(), keys.end());
+        int unique = (int)(std::unique(keys.begin(), keys.end()) - keys.begin());
+        return buildBalanced(keys.data(), 0, unique - 1);
+    }
+
+    // Traversals. In- and pre-order are Morris traversals: each node's in-order
+    // predecessor temporarily threads back to it, so they need no stack and leave
+    // the tree as they found it. Post-order uses a MAX_PATH stack.
+    void inOrder(JsonWriter &ss)
+    {
+        int n = root;
+        while (n != NIL)
+        {
+            if (pool[n].left == NIL)
+            {
+                ss << pool[n].key << " ";
+                n = pool[n].right;
+                continue;
+            }
+            int pred = pool[n].left;
+            while (pool[pred].right != NIL && pool[pred].right != n)
+                pred = pool[pred].right;
+            if (pool[pred].right == NIL)
+            {
+                pool[pred].right = n; // Thread back, then descend left
+                n = pool[n].left;
+            }
+            else
+            {
+                pool[pred].right = NIL; // Left subtree done: unthread and visit
+                ss << pool[n].key << " ";
+                n = pool[n].right;
+            }
+        }
+    }
+
+    void preOrder(JsonWriter &ss)
+    {
+        int n = root;
+        while (n != NIL)
+        {
+            if (pool[n].left == NIL)
+            {
+                ss << pool[n].key << " ";
+                n = pool[n].right;
+                continue;
+            }
+            int pred = pool[n].left;
+            while (pool[pred].right != NIL && pool[pred].right != n)
+                pred = pool[pred].right;
+            if (pool[pred].right == NIL)
+            {
+                ss << pool[n].key << " "; // Visit on the way down
+                pool[pred].right = n;
+                n = pool[n].left;
+            }
+            else
+            {
+                pool[pred].right = NIL;
+                n = pool[n].right;
+            }
+        }
+    }
+
+    void postOrder(JsonWriter &ss)
+    {
+        int stack[MAX_PATH];
+        int top = 0;
+        int n = root;
+        int last = NIL;
+        while (n != NIL || top > 0)
+        {
+            if (n != NIL)
+            {
+                stack[top++] = n;
+                n = pool[n].left;
+                continue;
+            }
+            int peek = stack[top - 1];
+            if (pool[peek].right != NIL && pool[peek].right != last)
+            {
+                n = pool[peek].right;
+            }
+            else
+            {
+                ss << pool[peek].key << " ";
+                last = peek;
+                top--;
+            }
+        }
+    }
+
+    void levelOrder(JsonWriter &ss)
+    {
+        if (root == NIL)
+            return;
+        std::queue<int> q;
+        q.push(root);
+        while (!q.empty())
+        {
+            int current = q.front();
+            q.pop();
+            ss << pool[current].key << " ";
+            if (pool[current].left != NIL)
+                q.push(pool[current].left);
+            if (pool[current].right != NIL)
+                q.push(pool[current].right);
+        }
+    }
+
+    // --- Frozen snapshot ---
+
+    void invalidateFrozen()
+    {
+        frozenValid = false;
+    }
+
+    // Slot of the first key >= key (0 if none) once k has run off the bottom:
+    // the last step that went left is the lowest 0 bit of k
+    static int eytzingerResult(int k)
+    {
+        return k >> __builtin_ffs(~k);
+    }
+
+    bool frozenLookup(int key)
+    {
+        const int *b = frozen.data();
+        int n = frozenCount;
+        int k = 1;
+        while (k <= n)
+        {
+            // Slot 16k starts the line holding k's descendants four levels down
+            __builtin_prefetch(b + 16 * k);
+            k = 2 * k + (b[k] < key);
+        }
+        k = eytzingerResult(k);
+        return k != 0 && b[k] == key;
+    }
+
+public:
+    AVLTree() : root(NIL), frozenCount(0), frozenValid(false), tracing(false) {}
+
+    bool insertKey(int key)
+    {
+        if (!insert(key))
+            return false;
+        invalidateFrozen();
+        return true;
+    }
+
+    bool removeKey(int key)
+    {
+        if (!remove(key))
+            return false;
+        invalidateFrozen();
+        return true;
+    }
+
+    // insertKey/removeKey that also record the event trace; return the event count
+    int insertKeyTraced(int key)
+    {
+        trace.clear();
+        tracing = true;
+        insertKey(key);
+        tracing = false;
+        return (int)trace.size();
+    }
+
+    int removeKeyTraced(int key)
+    {
+        trace.clear();
+        tracing = true;
+        removeKey(key);
+        tracing = false;
+        return (int)trace.size();
+    }
+
+    const TraceEvent *traceData() { return trace.data(); }
+
+    bool searchKey(int key) { return search(key); }
+
+    // Snapshots the keys into the Eytzinger array; returns the key count.
+    // Lookups on it are branch-free and touch one cache line per few levels,
+    // instead of chasing pool indices.
+    int freeze()
+    {
+        int n = size();
+        vector<int> sorted(n > 0 ? n : 1);
+        collectRange(INT_MIN, INT_MAX, sorted.data(), n);
+
+        frozen.assign(n + 1, 0);
+        frozenCount = n;
+        // In-order walk over the implicit tree, filling slots with ascending keys
+        int k = 1;
+        if (n > 0)
+        {
+            while (2 * k <= n)
+                k *= 2;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            frozen[k] = sorted[i];
+            if (2 * k + 1 <= n)
+            {
+                k = 2 * k + 1;
+                while (2 * k <= n)
+                    k *= 2;
+            }
+            else
+            {
+                while (k & 1)
+                    k >>= 1;
+                k >>= 1;
+            }
+        }
+        frozenValid = true;
+        return n;
+    }
+
+    bool isFrozen() { return frozenValid; }
+
+    // Falls back to the tree when there is no current snapshot
+    bool searchFrozen(int key)
+    {
+        return frozenValid ? frozenLookup(key) : search(key);
+    }
+
+    // out[i] = 1 if keys[i] is present (out may be null); returns the hit count.
+    // Queries advance FROZEN_BATCH at a time in lockstep so their cache misses
+    // overlap instead of serializing.
+    int searchFrozenBatch(const int *keys, int n, int *out)
+    {
+        int hits = 0;
+        if (!keys || n <= 0)
+            return 0;
+        if (!frozenValid)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                int found = search(keys[i]) ? 1 : 0;
+                if (out)
+                    out[i] = found;
+                hits += found;
+            }
+            return hits;
+        }
+
+        const int *b = frozen.data();
+        int count = frozenCount;
+        for (int base = 0; base < n; base += FROZEN_BATCH)
+        {
+            int lanes = n - base < FROZEN_BATCH ? n - base : FROZEN_BATCH;
+            int k[FROZEN_BATCH];
+            int x[FROZEN_BATCH];
+            for (int j = 0; j < FROZEN_BATCH; j++)
+            {
+                k[j] = 1;
+                x[j] = keys[base + (j < lanes ? j : 0)];
+            }
+
+            // Every lane runs off the bottom after at most floor(log2 n) + 1 steps
+            for (int level = 1; level <= count; level *= 2)
+            {
+                for (int j = 0; j < FROZEN_BATCH; j++)
+                {
+                    int kj = k[j];
+                    __builtin_prefetch(b + 16 * kj);
+                    int next = 2 * kj + (b[kj <= count ? kj : 0] < x[j]);
+                    k[j] = kj <= count ? next : kj;
+                }
+            }
+
+            for (int j = 0; j < lanes; j++)
+            {
+                int slot = eytzingerResult(k[j]);
+                int found = (slot != 0 && b[slot] == x[j]) ? 1 : 0;
+                if (out)
+                    out[base + j] = found;
+                hits += found;
+            }
+        }
+        return hits;
+    }
+
+    int size() { return subtreeSize(root); }
+    int getHeight() { return height(root); }
+
+    // Replaces the tree with a perfectly balanced one over vals[0..n) in O(n)
+    // (O(n log n) if the input has to be sorted first)
+    void buildFromSorted(const int *vals, int n)
+    {
+        clear();
+        root = buildSubtree(vals, n);
+    }
+
+    // Adds / keeps only the keys in vals[0..n) via split and join rather than n
+    // single-key operations
+    void unionWith(const int *vals, int n)
+    {
+        int other = buildSubtree(vals, n);
+        root = unionTrees(root, other);
+        invalidateFrozen();
+    }
+
+    void intersectWith(const int *vals, int n)
+    {
+        int other = buildSubtree(vals, n);
+        root = intersectTrees(root, other);
+        invalidateFrozen();
+    }
+
+    int rankOf(int key) { return countBelow(key, false); }
+
+    // k-th smallest key, 0-based (selectKth(rankOf(x)) == x for every key x).
+    // found is false when k is out of range.
+    int selectKth(int k, bool &found)
+    {
+        int n = selectNode(k);
+        found = (n != NIL);
+        return pool[n].key;
+    }
+
+    // Keys in [lo, hi], inclusive
+    int countRange(int lo, int hi)
+    {
+        if (lo > hi)
+            return 0;
+        return countBelow(hi, true) - countBelow(lo, false);
+    }
+
+    int rangeQuery(int lo, int hi, int *out, int max)
+    {
+        if (!out || max <= 0 || lo > hi)
+            return 0;
+        return collectRange(lo, hi, out, max);
+    }
+
+    // Drops every node in O(1); the pool keeps its memory for the next tree
+    void clear()
+    {
+        pool.reset();
+        root = NIL;
+        invalidateFrozen();
+    }
+
+    string getJSON()
+    {
+        string out;
+        out.reserve(40 * size() + 8);
+        toJSON(root, out);
+        return out;
+    }
+    string getTraversal(int type)
+    {
+        JsonWriter ss;
+        if (type == 0)
+            preOrder(ss);
+        else if (type == 1)
+            inOrder(ss);
+        else if (type == 2)
+            postOrder(ss);
+        else if (type == 3)
+            levelOrder(ss);
+        return ss.str();
+    }
+};
+
+#endif
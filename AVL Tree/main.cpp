@@ -1,8 +1,7 @@
-#include <iostream>
-#include <algorithm>
 #include <string>
-#include <sstream>
-#include <queue>
+#include <vector>
+#include <climits>
+#include <chrono>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -10,316 +9,318 @@
 #define EMSCRIPTEN_KEEPALIVE
 #endif
 
-using namespace std;
+#include "AVLTree.h"
+#include "../Common/ResultRing.h"
+#include "../Common/Exports.h"
 
-// --- AVL Logic ---
-
-struct Node
-{
-    int key;
-    Node *left;
-    Node *right;
-    int height;
-    Node(int k) : key(k), left(nullptr), right(nullptr), height(1) {}
-};
-
-class AVLTree
+// Times q random lookups (about half of them hits) through the tree, the frozen
+// snapshot one at a time, and searchFrozenBatch. Freezes the tree first.
+// Returns {"keys":..,"queries":..,"hits":..,"treeMs":..,"frozenMs":..,"batchMs":..}
+static string runSearchBenchmarkJSON(AVLTree &t, int q)
 {
-    Node *root;
-
-    int height(Node *N) { return N ? N->height : 0; }
-    int max(int a, int b) { return (a > b) ? a : b; }
-
-    Node *rightRotate(Node *y)
+    if (q < 0)
+        q = 0;
+    int n = t.size();
+    vector<int> keys(n > 0 ? n : 1);
+    t.rangeQuery(INT_MIN, INT_MAX, keys.data(), n);
+
+    vector<int> queries(q > 0 ? q : 1);
+    unsigned int state = 0x9E3779B9u;
+    for (int i = 0; i < q; i++)
     {
-        Node *x = y->left;
-        Node *T2 = x->right;
-        x->right = y;
-        y->left = T2;
-        y->height = max(height(y->left), height(y->right)) + 1;
-        x->height = max(height(x->left), height(x->right)) + 1;
-        return x;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        queries[i] = (n > 0 && (state & 1)) ? keys[(state >> 1) % n] : (int)(state >> 1);
     }
+    t.freeze();
+
+    int hits[3] = {0, 0, 0};
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int i = 0; i < q; i++)
+        hits[0] += t.searchKey(queries[i]) ? 1 : 0;
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    for (int i = 0; i < q; i++)
+        hits[1] += t.searchFrozen(queries[i]) ? 1 : 0;
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    hits[2] = t.searchFrozenBatch(queries.data(), q, nullptr);
+    chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+
+    JsonWriter ss;
+    ss << "{\"keys\":" << n << ",\"queries\":" << q << ",\"hits\":" << hits[0]
+       << ",\"agrees\":" << ((hits[0] == hits[1] && hits[1] == hits[2]) ? "true" : "false")
+       << ",\"treeMs\":" << chrono::duration<double, milli>(t1 - t0).count()
+       << ",\"frozenMs\":" << chrono::duration<double, milli>(t2 - t1).count()
+       << ",\"batchMs\":" << chrono::duration<double, milli>(t3 - t2).count() << "}";
+    return ss.str();
+}
 
-    Node *leftRotate(Node *x)
-    {
-        Node *y = x->right;
-        Node *T2 = y->left;
-        y->left = x;
-        x->right = T2;
-        x->height = max(height(x->left), height(x->right)) + 1;
-        y->height = max(height(y->left), height(y->right)) + 1;
-        return y;
-    }
+// --- Web Interface ---
 
-    int getBalance(Node *N) { return N ? height(N->left) - height(N->right) : 0; }
+AVLTree *tree = nullptr;
+// Output of rangeQuery calls that pass outPtr = 0 (read back with getRangeBuffer)
+vector<int> rangeBuffer;
+// Whether the last selectKth call had k in range (any int, -1 included, is a valid key)
+bool selectFound = false;
 
-    Node *insert(Node *node, int key)
+extern "C"
+{
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(initTree)()
     {
-        if (!node)
-            return new Node(key);
-        if (key < node->key)
-            node->left = insert(node->left, key);
-        else if (key > node->key)
-            node->right = insert(node->right, key);
+        if (tree)
+            tree->clear();
         else
-            return node;
+            tree = new AVLTree();
+    }
 
-        node->height = 1 + max(height(node->left), height(node->right));
-        int balance = getBalance(node);
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(insertNode)(int val)
+    {
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        tree->insertKey(val);
+        return resultRing.putString(tree->getJSON());
+    }
 
-        if (balance > 1 && key < node->left->key)
-            return rightRotate(node);
-        if (balance < -1 && key > node->right->key)
-            return leftRotate(node);
-        if (balance > 1 && key > node->left->key)
-        {
-            node->left = leftRotate(node->left);
-            return rightRotate(node);
-        }
-        if (balance < -1 && key < node->right->key)
-        {
-            node->right = rightRotate(node->right);
-            return leftRotate(node);
-        }
-        return node;
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(deleteNode)(int val)
+    {
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        tree->removeKey(val);
+        return resultRing.putString(tree->getJSON());
     }
 
-    Node *minValueNode(Node *node)
+    // Binary trace mode: same operation as insertNode/deleteNode, but instead of the
+    // tree JSON it leaves packed {type, key, value} int32 triplets in linear memory.
+    // Returns the number of events; read them from getTraceBuffer().
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(insertNodeTrace)(int val)
     {
-        Node *current = node;
-        while (current->left != nullptr)
-            current = current->left;
-        return current;
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        return tree->insertKeyTraced(val);
     }
 
-    Node *deleteNode(Node *root, int key)
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(deleteNodeTrace)(int val)
     {
-        if (!root)
-            return root;
-        if (key < root->key)
-            root->left = deleteNode(root->left, key);
-        else if (key > root->key)
-            root->right = deleteNode(root->right, key);
-        else
-        {
-            if (!root->left || !root->right)
-            {
-                Node *temp = root->left ? root->left : root->right;
-                if (!temp)
-                {
-                    temp = root;
-                    root = nullptr;
-                }
-                else
-                    *root = *temp;
-                delete temp;
-            }
-            else
-            {
-                Node *temp = minValueNode(root->right);
-                root->key = temp->key;
-                root->right = deleteNode(root->right, temp->key);
-            }
-        }
-        if (!root)
-            return root;
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        return tree->removeKeyTraced(val);
+    }
 
-        root->height = 1 + max(height(root->left), height(root->right));
-        int balance = getBalance(root);
+    EMSCRIPTEN_KEEPALIVE
+    const TraceEvent *ENGINE_EXPORT(getTraceBuffer)()
+    {
+        if (!tree)
+            return nullptr;
+        return tree->traceData();
+    }
 
-        if (balance > 1 && getBalance(root->left) >= 0)
-            return rightRotate(root);
-        if (balance > 1 && getBalance(root->left) < 0)
-        {
-            root->left = leftRotate(root->left);
-            return rightRotate(root);
-        }
-        if (balance < -1 && getBalance(root->right) <= 0)
-            return leftRotate(root);
-        if (balance < -1 && getBalance(root->right) > 0)
-        {
-            root->right = rightRotate(root->right);
-            return leftRotate(root);
-        }
-        return root;
+    // Bulk load from n ints in linear memory (sorted input builds in O(n)).
+    // Like the other bulk calls it returns the new size, not the tree JSON.
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(buildFromSorted)(const int *vals, int n)
+    {
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        tree->buildFromSorted(vals, n);
+        return tree->size();
     }
 
-    bool search(Node *root, int key)
+    // Tree becomes tree ∪ vals[0..n)
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(unionKeys)(const int *vals, int n)
     {
-        if (!root)
-            return false;
-        if (root->key == key)
-            return true;
-        if (key < root->key)
-            return search(root->left, key);
-        return search(root->right, key);
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        tree->unionWith(vals, n);
+        return tree->size();
     }
 
-    void toJSON(Node *root, stringstream &ss)
+    // Tree becomes tree ∩ vals[0..n)
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(intersectKeys)(const int *vals, int n)
     {
-        if (!root)
-        {
-            ss << "null";
-            return;
-        }
-        ss << "{"
-           << "\"value\":" << root->key << ","
-           << "\"height\":" << root->height << ","
-           << "\"children\":["; // D3 prefers 'children' array
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        tree->intersectWith(vals, n);
+        return tree->size();
+    }
 
-        // Always output two children for binary tree structure
-        toJSON(root->left, ss);
-        ss << ",";
-        toJSON(root->right, ss);
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(getTreeSize)()
+    {
+        return tree ? tree->size() : 0;
+    }
 
-        ss << "]}";
+    // Number of keys < key
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(rankOf)(int key)
+    {
+        return tree ? tree->rankOf(key) : 0;
     }
 
-    // Traversals
-    void preOrder(Node *root, stringstream &ss)
+    // k-th smallest key (0-based). Out of range it returns 0 and selectKthFound()
+    // reports 0; the return value alone cannot flag that, since keys may be negative.
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(selectKth)(int k)
     {
-        if (!root)
-            return;
-        ss << root->key << " ";
-        preOrder(root->left, ss);
-        preOrder(root->right, ss);
+        selectFound = false;
+        if (!tree)
+            return 0;
+        int key = tree->selectKth(k, selectFound);
+        return selectFound ? key : 0;
     }
-    void inOrder(Node *root, stringstream &ss)
+
+    // 1 if the last selectKth call found a key, 0 if its k was out of range
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(selectKthFound)()
     {
-        if (!root)
-            return;
-        inOrder(root->left, ss);
-        ss << root->key << " ";
-        inOrder(root->right, ss);
+        return selectFound ? 1 : 0;
     }
-    void postOrder(Node *root, stringstream &ss)
+
+    // Number of keys in [lo, hi]
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(countRange)(int lo, int hi)
     {
-        if (!root)
-            return;
-        postOrder(root->left, ss);
-        postOrder(root->right, ss);
-        ss << root->key << " ";
+        return tree ? tree->countRange(lo, hi) : 0;
     }
 
-    void levelOrder(Node *root, stringstream &ss)
+    // Writes up to max keys in [lo, hi], ascending, to outPtr and returns the count.
+    // With outPtr = 0 they go to a module-owned buffer exposed by getRangeBuffer.
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(rangeQuery)(int lo, int hi, int *outPtr, int max)
     {
-        if (!root)
-            return;
-        std::queue<Node *> q;
-        q.push(root);
-        while (!q.empty())
+        STAT_TIME_SCOPE();
+        if (!tree || max <= 0)
+            return 0;
+        if (!outPtr)
         {
-            Node *current = q.front();
-            q.pop();
-            ss << current->key << " ";
-            if (current->left)
-                q.push(current->left);
-            if (current->right)
-                q.push(current->right);
+            rangeBuffer.resize(max);
+            outPtr = rangeBuffer.data();
         }
+        return tree->rangeQuery(lo, hi, outPtr, max);
     }
 
-    void deleteTree(Node *node)
+    EMSCRIPTEN_KEEPALIVE
+    int *ENGINE_EXPORT(getRangeBuffer)()
     {
-        if (!node)
-            return;
-        deleteTree(node->left);
-        deleteTree(node->right);
-        delete node;
+        return rangeBuffer.empty() ? nullptr : rangeBuffer.data();
     }
 
-public:
-    AVLTree() : root(nullptr) {}
-    ~AVLTree() { deleteTree(root); }
-    void insertKey(int key) { root = insert(root, key); }
-    void removeKey(int key) { root = deleteNode(root, key); }
-    bool searchKey(int key) { return search(root, key); }
-
-    string getJSON()
+    // Snapshots the tree for searchFrozen / searchFrozenBatch; returns the key count.
+    // Any later insert, delete or bulk operation drops the snapshot again.
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(freezeTree)()
     {
-        stringstream ss;
-        toJSON(root, ss);
-        return ss.str();
+        STAT_TIME_SCOPE();
+        if (!tree)
+            ENGINE_EXPORT(initTree)();
+        return tree->freeze();
     }
-    string getTraversal(int type)
+
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(isTreeFrozen)()
     {
-        stringstream ss;
-        if (type == 0)
-            preOrder(root, ss);
-        else if (type == 1)
-            inOrder(root, ss);
-        else if (type == 2)
-            postOrder(root, ss);
-        else if (type == 3)
-            levelOrder(root, ss);
-        return ss.str();
+        return (tree && tree->isFrozen()) ? 1 : 0;
     }
-};
-
-// --- Web Interface ---
 
-AVLTree *tree = nullptr;
-string buffer;
-
-extern "C"
-{
+    // Same answer as searchNode; uses the snapshot when it is current
     EMSCRIPTEN_KEEPALIVE
-    void initTree()
+    int ENGINE_EXPORT(searchFrozen)(int val)
     {
-        if (tree)
-            delete tree;
-        tree = new AVLTree();
+        if (!tree)
+            return 0;
+        return tree->searchFrozen(val) ? 1 : 0;
     }
 
+    // Looks up n keys from ptr. outPtr (optional, may be 0) receives 1/0 per key.
+    // Returns the number of hits.
     EMSCRIPTEN_KEEPALIVE
-    const char *insertNode(int val)
+    int ENGINE_EXPORT(searchFrozenBatch)(const int *ptr, int n, int *outPtr)
     {
+        STAT_TIME_SCOPE();
         if (!tree)
-            initTree();
-        tree->insertKey(val);
-        buffer = tree->getJSON();
-        return buffer.c_str();
+            return 0;
+        return tree->searchFrozenBatch(ptr, n, outPtr);
     }
 
     EMSCRIPTEN_KEEPALIVE
-    const char *deleteNode(int val)
+    const char *ENGINE_EXPORT(runSearchBenchmark)(int queries)
     {
         if (!tree)
-            initTree();
-        tree->removeKey(val);
-        buffer = tree->getJSON();
-        return buffer.c_str();
+            ENGINE_EXPORT(initTree)();
+        return resultRing.putString(runSearchBenchmarkJSON(*tree, queries));
     }
 
     EMSCRIPTEN_KEEPALIVE
-    int searchNode(int val)
+    int ENGINE_EXPORT(getTreeHeight)()
     {
+        return tree ? tree->getHeight() : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(searchNode)(int val)
+    {
+        STAT_TIME_SCOPE();
         if (!tree)
             return 0;
         return tree->searchKey(val) ? 1 : 0;
     }
 
     EMSCRIPTEN_KEEPALIVE
-    const char *getTreeJSON()
+    const char *ENGINE_EXPORT(getTreeJSON)()
     {
+        STAT_TIME_SCOPE();
         if (!tree)
-            return "null";
-        buffer = tree->getJSON();
-        return buffer.c_str();
+            return resultRing.putString("null");
+        return resultRing.putString(tree->getJSON());
     }
 
     EMSCRIPTEN_KEEPALIVE
-    const char *getTraversal(int type)
+    const char *ENGINE_EXPORT(getTraversal)(int type)
     {
         if (!tree)
-            return "";
-        buffer = tree->getTraversal(type);
-        return buffer.c_str();
+            return resultRing.putString("");
+        return resultRing.putString(tree->getTraversal(type));
+    }
+
+    // Instrumentation counters and export timings (see Common/Stats.h)
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(getStats)()
+    {
+        return resultRing.putString(statsToJSON(STATS_MODULE));
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(resetStats)()
+    {
+        resetEngineStats(STATS_MODULE);
+    }
+
+    // Where the string exports' results live (Common/ResultRing.h); engine.js
+    // reads this once and decodes results straight out of the ring
+    EMSCRIPTEN_KEEPALIVE
+    const ResultRingInfo *ENGINE_EXPORT(getResultRing)()
+    {
+        return resultRing.getInfo();
     }
 }
 
+// The combined build (Combined/combined.cpp) supplies its own main
+#ifndef COMBINED_BUILD
 int main()
 {
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -15,13 +15,25 @@ const CONFIG = {
         stroke: "#ffffff",
         text: "#ffffff"
     },
-    nodeRadius: 20
+    nodeRadius: 20,
+    maxRenderNodes: 255,    // Larger trees (bulk builds) only update the stats panel
+    maxRangeKeys: 200       // Keys listed by the Range query
 };
 
+// Event types of the binary insert/delete trace (mirror of TraceEventType in AVLTree.h)
+const TRACE_EVENTS = [
+    "visit", "inserted", "duplicate", "not_found", "replaced",
+    "removed", "height", "rotate_left", "rotate_right"
+];
+
 // Global State
 let svg, g, treeLayout, rootHierarchy;
-let currentTreeData = null; // JSON object from C++
+let currentTreeData = null; // JSON object from C++, kept in step by the trace events
+// Key -> node of currentTreeData and key -> its parent (null for the root)
+let treeIndex = new Map();
+let treeParent = new Map();
 let isWasmReady = false;
+let useBinaryTrace = true; // Cleared if the loaded module has no *Trace exports
 
 
 // Store previous positions for smooth transitions
@@ -33,8 +45,8 @@ window.onload = function() {
     initD3();
     setupEventListeners();
 
-    // Check if Module loaded fast
-    if (typeof Module !== 'undefined' && Module.runtimeInitialized) {
+    // Check if the engine loaded fast (see ../engine.js)
+    if (Engine.isReady()) {
         onReady();
     }
     
@@ -43,15 +55,15 @@ window.onload = function() {
     makeDraggable(document.getElementById('outputPanel'), document.getElementById('outputDragHandle'));
 };
 
-function onReady() {
+async function onReady() {
     isWasmReady = true;
     const status = document.getElementById('systemStatus');
     if (status) status.innerHTML = '<span class="status-dot ready"></span> System: Ready';
     
-    logConsole(">> WASM Core Loaded. AVL Tree Ready.");
+    logConsole(`>> WASM Core Loaded (${Engine.mode} mode). AVL Tree Ready.`);
     
     // Initialize empty tree in C++
-    Module.ccall('initTree', null, [], []);
+    await Engine.call('initTree', null, [], []);
     updateStats();
 }
 
@@ -90,11 +102,20 @@ function setupEventListeners() {
     document.getElementById('searchBtn').onclick = handleSearch;
     document.getElementById('generateRandomBtn').onclick = handleRandom;
     document.getElementById('clearBtn').onclick = handleClear;
+    document.getElementById('buildBtn').onclick = () => handleBulk('buildFromSorted', "Built");
+    document.getElementById('unionBtn').onclick = () => handleBulk('unionKeys', "Union");
+    document.getElementById('intersectBtn').onclick = () => handleBulk('intersectKeys', "Intersection");
+    document.getElementById('searchBenchBtn').onclick = handleSearchBenchmark;
 
     document.getElementById('inOrderBtn').onclick = () => handleTraversal(1);
     document.getElementById('preOrderBtn').onclick = () => handleTraversal(0);
     document.getElementById('postOrderBtn').onclick = () => handleTraversal(2);
     document.getElementById('levelOrderBtn').onclick = () => handleTraversal(3);
+
+    document.getElementById('rankBtn').onclick = () => handleOrderStat('rank');
+    document.getElementById('selectBtn').onclick = () => handleOrderStat('select');
+    document.getElementById('countRangeBtn').onclick = () => handleOrderStat('count');
+    document.getElementById('rangeBtn').onclick = () => handleOrderStat('range');
     
     document.getElementById('btnClearOutput').onclick = () => {
         document.getElementById('outputBody').innerHTML = '<div class="log-entry system">Cleared.</div>';
@@ -105,7 +126,7 @@ function setupEventListeners() {
     };
 }
 
-function handleInsert() {
+async function handleInsert() {
     if (!isWasmReady) return;
     const val = parseInt(document.getElementById('nodeValue').value);
     
@@ -115,35 +136,227 @@ function handleInsert() {
     }
 
     logConsole(`>> Inserting ${val}...`);
-    const jsonStr = Module.ccall('insertNode', 'string', ['number'], [val]);
-    processTreeUpdate(jsonStr);
-    logConsole(`>> Node ${val} inserted.`);
+    const events = await runTraced('insertNode', val);
+    if (!events) {
+        processTreeUpdate(await Engine.call('insertNode', 'string', ['number'], [val]));
+        logConsole(`>> Node ${val} inserted.`);
+        return;
+    }
+    await applyTrace(events);
 }
 
-function handleDelete() {
+async function handleDelete() {
     if (!isWasmReady) return;
     const val = parseInt(document.getElementById('nodeValue').value);
     
     if (isNaN(val)) return;
 
     logConsole(`>> Deleting ${val}...`);
-    const jsonStr = Module.ccall('deleteNode', 'string', ['number'], [val]);
-    processTreeUpdate(jsonStr);
-    logConsole(`>> Node ${val} deleted (if existed).`);
+    const events = await runTraced('deleteNode', val);
+    if (!events) {
+        processTreeUpdate(await Engine.call('deleteNode', 'string', ['number'], [val]));
+        logConsole(`>> Node ${val} deleted (if existed).`);
+        return;
+    }
+    await applyTrace(events);
+}
+
+// Runs insertNode/deleteNode in binary trace mode: C++ leaves {type, key, value}
+// int32 triplets in memory and we decode them straight out of a heap view. Returns
+// null if the loaded module predates the trace exports, so the caller can use the
+// JSON call instead.
+async function runTraced(fnName, val) {
+    if (!useBinaryTrace) return null;
+    try {
+        const count = await Engine.call(fnName + 'Trace', 'number', ['number'], [val]);
+        const raw = await Engine.viewInt32('getTraceBuffer', count * 3);
+        const events = new Array(count);
+        for (let i = 0; i < count; i++) {
+            events[i] = { type: TRACE_EVENTS[raw[i * 3]], key: raw[i * 3 + 1], value: raw[i * 3 + 2] };
+        }
+        return events;
+    } catch (e) {
+        console.warn("Binary trace unavailable, using tree JSON:", e);
+        useBinaryTrace = false;
+        return null;
+    }
+}
+
+// Logs and animates one traced operation. Work scales with the event count: a
+// duplicate insert or missing delete only lights up the visited path, and trees
+// past maxRenderNodes only get their counters updated. Structural events are
+// replayed onto currentTreeData; the tree JSON is fetched only to resync when the
+// drawn tree and the engine disagree (e.g. the tree was too large to draw before).
+async function applyTrace(events) {
+    let structural = false;
+    const visited = [];
+    events.forEach((e, i) => {
+        if (e.type === "visit") visited.push(e.key);
+        else if (e.type === "inserted") { structural = true; logConsole(`>> Node ${e.key} inserted at depth ${e.value}.`); }
+        else if (e.type === "duplicate") logConsole(`>> ${e.key} is already in the tree.`);
+        else if (e.type === "not_found") logConsole(`>> ${e.key} not found.`);
+        else if (e.type === "replaced") { structural = true; logConsole(`>> Node ${e.key} deleted; its successor ${e.value} takes its place.`); }
+        else if (e.type === "removed") {
+            structural = true;
+            // A two-child delete reports the successor's node here; "replaced" names the key
+            if (!(events[i + 1] && events[i + 1].type === "replaced")) logConsole(`>> Node ${e.key} deleted.`);
+        }
+        else if (e.type === "rotate_left") logConsole(`>> Left rotation at ${e.key} (${e.value} moves up).`);
+        else if (e.type === "rotate_right") logConsole(`>> Right rotation at ${e.key} (${e.value} moves up).`);
+    });
+
+    if (structural) {
+        const size = await Engine.call('getTreeSize', 'number', [], []);
+        if (size > CONFIG.maxRenderNodes) {
+            currentTreeData = null;
+            indexTree(null);
+            updateD3(null);
+            const height = await Engine.call('getTreeHeight', 'number', [], []);
+            document.getElementById('treeHeight').innerText = height;
+            document.getElementById('nodeCount').innerText = size;
+            Engine.renderStats(document.getElementById('engineStats'));
+            return;
+        }
+        if (applyTraceToTree(events) && treeIndex.size === size) {
+            updateD3(currentTreeData);
+            updateStats();
+        } else {
+            processTreeUpdate(await Engine.call('getTreeJSON', 'string', [], []));
+        }
+    } else {
+        Engine.renderStats(document.getElementById('engineStats'));
+    }
+    highlightPath(visited);
+}
+
+// Rebuilds the key and parent maps after currentTreeData was replaced wholesale
+function indexTree(data) {
+    treeIndex.clear();
+    treeParent.clear();
+    if (!data) return;
+    const stack = [[data, null]];
+    while (stack.length) {
+        const [node, parent] = stack.pop();
+        treeIndex.set(node.value, node);
+        treeParent.set(node.value, parent);
+        node.children.forEach(c => { if (c) stack.push([c, node]); });
+    }
+}
+
+// Points parent's link (or the root) at newChild where it pointed at oldChild
+function relink(parent, oldChild, newChild) {
+    if (!parent) currentTreeData = newChild;
+    else parent.children[parent.children[0] === oldChild ? 0 : 1] = newChild;
+    if (newChild) treeParent.set(newChild.value, parent);
+}
+
+// Applies the events to currentTreeData the way AVLTree.h changed its nodes, in
+// the same order. Returns false if an event does not fit the tree held here, in
+// which case the caller resyncs from the tree JSON.
+function applyTraceToTree(events) {
+    let lastVisit = null;
+    for (const e of events) {
+        switch (e.type) {
+        case "visit":
+            lastVisit = e.key;
+            break;
+        case "inserted": {
+            // A new leaf under the last node on the search path
+            const node = { value: e.key, height: 1, children: [null, null] };
+            if (lastVisit === null) {
+                if (currentTreeData) return false;
+                currentTreeData = node;
+                treeParent.set(e.key, null);
+            } else {
+                const parent = treeIndex.get(lastVisit);
+                if (!parent) return false;
+                parent.children[e.key < parent.value ? 0 : 1] = node;
+                treeParent.set(e.key, parent);
+            }
+            treeIndex.set(e.key, node);
+            break;
+        }
+        case "removed": {
+            // The unlinked node has at most one child, which takes its place
+            const node = treeIndex.get(e.key);
+            if (!node || (node.children[0] && node.children[1])) return false;
+            relink(treeParent.get(e.key), node, node.children[0] || node.children[1]);
+            treeIndex.delete(e.key);
+            treeParent.delete(e.key);
+            break;
+        }
+        case "replaced": {
+            // The deleted key's node keeps its place and takes the successor's key
+            const node = treeIndex.get(e.key);
+            if (!node) return false;
+            const parent = treeParent.get(e.key);
+            treeIndex.delete(e.key);
+            treeParent.delete(e.key);
+            node.value = e.value;
+            treeIndex.set(e.value, node);
+            treeParent.set(e.value, parent);
+            break;
+        }
+        case "height": {
+            const node = treeIndex.get(e.key);
+            if (!node) return false;
+            node.height = e.value;
+            break;
+        }
+        case "rotate_right": {
+            // Pivot y, its left child x moves up: y.left = x.right, x.right = y
+            const y = treeIndex.get(e.key), x = treeIndex.get(e.value);
+            if (!y || !x || y.children[0] !== x) return false;
+            const inner = x.children[1];
+            relink(treeParent.get(e.key), y, x);
+            y.children[0] = inner;
+            if (inner) treeParent.set(inner.value, y);
+            x.children[1] = y;
+            treeParent.set(y.value, x);
+            break;
+        }
+        case "rotate_left": {
+            // Pivot x, its right child y moves up: x.right = y.left, y.left = x
+            const x = treeIndex.get(e.key), y = treeIndex.get(e.value);
+            if (!x || !y || x.children[1] !== y) return false;
+            const inner = y.children[0];
+            relink(treeParent.get(e.key), x, y);
+            x.children[1] = inner;
+            if (inner) treeParent.set(inner.value, x);
+            y.children[0] = x;
+            treeParent.set(x.value, y);
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+// Briefly marks the nodes an operation walked past
+function highlightPath(keys) {
+    keys.forEach((key, i) => {
+        d3.select(`#node-${key} circle`)
+            .transition().delay(i * 120).duration(200)
+            .style("stroke", CONFIG.colors.processing)
+            .style("fill", "#fffbeb")
+            .transition().delay(600).duration(300)
+            .style("stroke", CONFIG.colors.default)
+            .style("fill", "#fff");
+    });
 }
 
-function handleSearch() {
+async function handleSearch() {
     if (!isWasmReady || !currentTreeData) return;
     const val = parseInt(document.getElementById('nodeValue').value);
     if (isNaN(val)) return;
 
     resetNodeVisuals();
-    const found = Module.ccall('searchNode', 'number', ['number'], [val]);
+    const found = await Engine.call('searchNode', 'number', ['number'], [val]);
     logConsole(`>> Searching for ${val}...`);
     animateSearchPath(currentTreeData, val, found === 1);
 }
 
-function handleTraversal(type) {
+async function handleTraversal(type) {
     if (!isWasmReady) return;
     const types = ["PreOrder", "InOrder", "PostOrder", "LevelOrder"];
     const name = types[type];
@@ -151,7 +364,7 @@ function handleTraversal(type) {
     logConsole(`>> Running ${name} Traversal...`);
     resetNodeVisuals();
 
-    const resultStr = Module.ccall('getTraversal', 'string', ['number'], [type]);
+    const resultStr = await Engine.call('getTraversal', 'string', ['number'], [type]);
     
     if (!resultStr || resultStr.trim() === "") {
         updateOutputPanel("Tree is empty.");
@@ -164,25 +377,103 @@ function handleTraversal(type) {
     animateSequence(arr);
 }
 
+// Rank / select / range answers come straight from C++ instead of parsing a traversal
+async function handleOrderStat(kind) {
+    if (!isWasmReady) return;
+    const lo = parseInt(document.getElementById('rangeLo').value);
+    const hi = parseInt(document.getElementById('rangeHi').value);
+    if (isNaN(lo) || (kind !== 'rank' && kind !== 'select' && isNaN(hi))) return;
+
+    let html;
+    if (kind === 'rank') {
+        const rank = await Engine.call('rankOf', 'number', ['number'], [lo]);
+        html = `${rank} keys are smaller than ${lo}.`;
+    } else if (kind === 'select') {
+        const size = await Engine.call('getTreeSize', 'number', [], []);
+        if (lo < 0 || lo >= size) {
+            html = `k must be between 0 and ${size - 1}.`;
+        } else {
+            const key = await Engine.call('selectKth', 'number', ['number'], [lo]);
+            const found = await Engine.call('selectKthFound', 'number', [], []);
+            html = found ? `Key #${lo} (0-based) is ${key}.` : `k must be between 0 and ${size - 1}.`;
+        }
+    } else if (kind === 'count') {
+        const count = await Engine.call('countRange', 'number', ['number', 'number'], [lo, hi]);
+        html = `${count} keys in [${lo}, ${hi}].`;
+    } else {
+        // outPtr = 0: C++ fills its own buffer, which is then read back in one copy
+        const n = await Engine.call('rangeQuery', 'number', ['number', 'number', 'number', 'number'], [lo, hi, 0, CONFIG.maxRangeKeys]);
+        const keys = Array.from(await Engine.viewInt32('getRangeBuffer', n));
+        html = n ? keys.join(' <span style="color:#6b7280">→</span> ') : "No keys in range.";
+        if (n === CONFIG.maxRangeKeys) html += ` (first ${n} shown)`;
+    }
+    updateOutputPanel(`<div class="log-entry system">>> Order statistics:</div><div class="log-entry">${html}</div>`);
+}
+
 function handleRandom() {
     const val = Math.floor(Math.random() * 100);
     document.getElementById('nodeValue').value = val;
     handleInsert();
 }
 
-function handleClear() {
-    Module.ccall('initTree', null, [], []);
+async function handleClear() {
+    await Engine.call('initTree', null, [], []);
     previousNodePositions.clear();
     processTreeUpdate("null");
     logConsole(">> Tree Cleared.");
     updateOutputPanel("Tree cleared.");
 }
 
+// Bulk set operations: n random keys go to C++ in one call (sorted, so the
+// build side is O(n)), and the tree is fetched once afterwards
+async function handleBulk(fn, label) {
+    if (!isWasmReady) return;
+    const n = parseInt(document.getElementById('bulkCount').value);
+    if (isNaN(n) || n < 1) return;
+
+    const keys = new Int32Array(n);
+    for (let i = 0; i < n; i++) keys[i] = Math.floor(Math.random() * 4 * n);
+    keys.sort();
+
+    logConsole(`>> ${label} with ${n} random keys...`);
+    const t0 = performance.now();
+    const size = await Engine.call(fn, 'number', ['int32array', 'number'], [keys, n]);
+    logConsole(`${label}: ${size} keys in the tree after ${(performance.now() - t0).toFixed(1)} ms.`);
+
+    previousNodePositions.clear();
+    if (size > CONFIG.maxRenderNodes) {
+        logConsole(`(Tree too large to draw; showing stats only.)`);
+        currentTreeData = null;
+        indexTree(null);
+        updateD3(null);
+        const height = await Engine.call('getTreeHeight', 'number', [], []);
+        document.getElementById('treeHeight').innerText = height;
+        document.getElementById('nodeCount').innerText = size;
+        return;
+    }
+    processTreeUpdate(await Engine.call('getTreeJSON', 'string', [], []));
+}
+
+// Freezes the tree into its Eytzinger snapshot and times pointer-chasing search
+// against single and batched snapshot lookups (all in C++)
+async function handleSearchBenchmark() {
+    if (!isWasmReady) return;
+    const QUERIES = 200000;
+    logConsole(`>> Freezing tree and running ${QUERIES} lookups per mode...`);
+    const r = JSON.parse(await Engine.call('runSearchBenchmark', 'string', ['number'], [QUERIES]));
+    const flag = r.agrees ? "" : " (MISMATCH)";
+    logConsole(`${r.keys} keys, ${r.hits} hits${flag}`);
+    logConsole(`tree   ${r.treeMs.toFixed(1)} ms`);
+    logConsole(`frozen ${r.frozenMs.toFixed(1)} ms`);
+    logConsole(`batch  ${r.batchMs.toFixed(1)} ms`);
+}
+
 // --- Core D3.js Rendering (Fixed Logic) ---
 
 function processTreeUpdate(jsonStr) {
     if (jsonStr === "null") {
         currentTreeData = null;
+        indexTree(null);
         updateD3(null);
         updateStats();
         return;
@@ -190,6 +481,7 @@ function processTreeUpdate(jsonStr) {
 
     try {
         currentTreeData = JSON.parse(jsonStr);
+        indexTree(currentTreeData);
         updateD3(currentTreeData);
         updateStats();
     } catch (e) {
@@ -422,6 +714,7 @@ function animateSequence(values) {
 // --- Helpers ---
 
 function updateStats() {
+    Engine.renderStats(document.getElementById('engineStats'));
     if (!currentTreeData) {
         document.getElementById('treeHeight').innerText = "0";
         document.getElementById('nodeCount').innerText = "0";
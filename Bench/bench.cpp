@@ -0,0 +1,311 @@
+// Benchmark harness for the four engines, built natively or as WASM (see the
+// "Build Bench" tasks in .vscode/tasks.json). Each engine runs a synthetic workload
+// at every requested size; every phase reports throughput, per-op latency
+// percentiles and the process's peak memory so far.
+//
+//   bench [--sizes 1e3,1e4,1e5,1e6] [--engines hash,heap,avl,graph]
+//         [--probe 5] [--degree 8] [--json]
+//
+// Sizes are key / vertex counts (10^3 .. 10^7 is the intended range). Peak memory
+// only ever grows, so run one engine per process to attribute it to that engine.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#if defined(__EMSCRIPTEN__)
+// Linear memory never shrinks, so its current size is the peak
+#elif defined(_WIN32)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../Hash/HashTable.h"
+#include "../Binary Heap/Heap.h"
+#include "../AVL Tree/AVLTree.h"
+#include "../Graph/Graph.h"
+
+using namespace std;
+
+// Ops timed individually per phase; the rest run back to back. Sampling every
+// k-th op keeps the clock reads from dominating sub-100 ns operations.
+static const int LATENCY_SAMPLES = 20000;
+
+struct BenchOptions
+{
+    vector<int> sizes;
+    bool engines[4]; // hash, heap, avl, graph
+    int probeType;
+    int degree;
+    bool json;
+};
+
+static const char *ENGINE_NAMES[] = {"hash", "heap", "avl", "graph"};
+
+// Lookup results land here so the compiler cannot drop side-effect-free searches
+static volatile int benchSink;
+
+// --- Measurement ---
+
+static double peakMemoryMB()
+{
+#if defined(__EMSCRIPTEN__)
+    return __builtin_wasm_memory_size(0) * 65536.0 / (1024 * 1024);
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+#endif
+}
+
+// Scrambles i into a non-negative key. Every step is a bijection on 31 bits
+// (odd multiplies and xor-shifts), so distinct i give distinct keys.
+static int mixKey(unsigned i)
+{
+    const unsigned mask = 0x7fffffffu;
+    i &= mask;
+    i ^= i >> 15;
+    i = (i * 0x2c1b3c6du) & mask;
+    i ^= i >> 12;
+    i = (i * 0x297a2d39u) & mask;
+    i ^= i >> 15;
+    return (int)i;
+}
+
+static double percentile(const vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void report(const BenchOptions &opt, const char *engine, const char *phase, int n,
+                   long long ops, double totalNs, vector<double> &samples)
+{
+    sort(samples.begin(), samples.end());
+    double opsPerSec = totalNs > 0 ? ops * 1e9 / totalNs : 0;
+    double p50 = percentile(samples, 0.50);
+    double p90 = percentile(samples, 0.90);
+    double p99 = percentile(samples, 0.99);
+    double peak = peakMemoryMB();
+    if (opt.json)
+    {
+        printf("{\"engine\":\"%s\",\"phase\":\"%s\",\"n\":%d,\"ops\":%lld,\"opsPerSec\":%.0f,"
+               "\"p50Ns\":%.1f,\"p90Ns\":%.1f,\"p99Ns\":%.1f,\"peakMB\":%.1f}\n",
+               engine, phase, n, ops, opsPerSec, p50, p90, p99, peak);
+    }
+    else
+    {
+        printf("%-6s %-10s %9d %12.0f %10.1f %10.1f %10.1f %9.1f\n",
+               engine, phase, n, opsPerSec, p50, p90, p99, peak);
+    }
+    fflush(stdout);
+}
+
+// Runs op(0) .. op(ops - 1), timing about LATENCY_SAMPLES of them on their own
+template <typename Op>
+static void runPhase(const BenchOptions &opt, const char *engine, const char *phase, int n,
+                     int ops, Op op)
+{
+    int stride = ops / LATENCY_SAMPLES + 1;
+    vector<double> samples;
+    samples.reserve(ops / stride + 1);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < ops; i++)
+    {
+        if (i % stride != 0)
+        {
+            op(i);
+            continue;
+        }
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        op(i);
+        samples.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+    }
+    double totalNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    report(opt, engine, phase, n, ops, totalNs, samples);
+}
+
+// Whole-structure builds: op() runs 'runs' times and handles 'elements' items each
+// time. The row counts elements, not builds, so ops/s is elements per second, and
+// every percentile sample is one run's time divided by elements. That keeps these
+// rows comparable with the per-op ones.
+template <typename Op>
+static void runBulkPhase(const BenchOptions &opt, const char *engine, const char *phase, int n,
+                         int elements, int runs, Op op)
+{
+    vector<double> samples;
+    samples.reserve(runs);
+    double totalNs = 0;
+    for (int r = 0; r < runs; r++)
+    {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        op();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+        totalNs += ns;
+        samples.push_back(ns / (elements > 0 ? elements : 1));
+    }
+    report(opt, engine, phase, n, (long long)elements * runs, totalNs, samples);
+}
+
+// Repetitions of whole-structure runs (builds, traversals) at size n
+static int repeatCount(int n)
+{
+    return n >= 1000000 ? 3 : (n >= 100000 ? 10 : 50);
+}
+
+// --- Workloads ---
+
+// Keys mixKey(0 .. n) are inserted; mixKey(n + i) are guaranteed misses
+static void benchHash(const BenchOptions &opt, int n)
+{
+    HashTable table(16, HASH_MURMUR);
+    table.setTraceEnabled(false);
+    int probe = opt.probeType;
+    runPhase(opt, "hash", "insert", n, n, [&](int i) { table.insertTraced(mixKey(i), probe); });
+    runPhase(opt, "hash", "search-hit", n, n, [&](int i) { benchSink = table.searchTraced(mixKey(i), probe); });
+    runPhase(opt, "hash", "search-miss", n, n, [&](int i) { benchSink = table.searchTraced(mixKey(n + i), probe); });
+    runPhase(opt, "hash", "remove", n, n, [&](int i) { table.removeTraced(mixKey(i), probe); });
+}
+
+static void benchHeap(const BenchOptions &opt, int n)
+{
+    Heap<MinCompare> heap(16);
+    runPhase(opt, "heap", "insert", n, n, [&](int i) { heap.insert(mixKey(i)); });
+    runPhase(opt, "heap", "extract", n, n, [&](int) { heap.extract(); });
+
+    vector<int> vals(n);
+    for (int i = 0; i < n; i++)
+        vals[i] = mixKey(i);
+    runBulkPhase(opt, "heap", "build", n, n, repeatCount(n), [&]() { heap.build(vals.data(), n); });
+}
+
+static void benchAVL(const BenchOptions &opt, int n)
+{
+    AVLTree tree;
+    runPhase(opt, "avl", "insert", n, n, [&](int i) { tree.insertKey(mixKey(i)); });
+    runPhase(opt, "avl", "search-hit", n, n, [&](int i) { benchSink = tree.searchKey(mixKey(i)); });
+    runPhase(opt, "avl", "search-miss", n, n, [&](int i) { benchSink = tree.searchKey(mixKey(n + i)); });
+    tree.freeze();
+    runPhase(opt, "avl", "frozen-hit", n, n, [&](int i) { benchSink = tree.searchFrozen(mixKey(i)); });
+    runPhase(opt, "avl", "remove", n, n, [&](int i) { tree.removeKey(mixKey(i)); });
+}
+
+// Random graph with n vertices and n * degree / 2 undirected edges. "finalize"
+// counts those edges as its elements (see runBulkPhase). Traversals are timed per
+// run from a handful of sources, so their "ops" are whole traversals.
+static void benchGraph(const BenchOptions &opt, int n)
+{
+    Graph graph(n);
+    int edges = (int)((long long)n * opt.degree / 2);
+    unsigned state = 12345;
+    runPhase(opt, "graph", "add-edge", n, edges, [&](int) {
+        state = state * 1664525u + 1013904223u;
+        int u = (int)((state >> 8) % (unsigned)n);
+        state = state * 1664525u + 1013904223u;
+        int v = (int)((state >> 8) % (unsigned)n);
+        graph.addEdge(u, v, 1 + (int)(state & 63));
+    });
+    runBulkPhase(opt, "graph", "finalize", n, edges, repeatCount(n), [&]() { graph.finalize(); });
+
+    int runs = repeatCount(n);
+    vector<int> out(n);
+    runPhase(opt, "graph", "bfs", n, runs, [&](int i) { graph.BFS(mixKey(i) % n, out.data()); });
+    runPhase(opt, "graph", "dijkstra", n, runs, [&](int i) {
+        graph.DijkstraAlgorithm(mixKey(i) % n, out.data(), PQ_DARY4);
+    });
+}
+
+// --- Command line ---
+
+static void parseSizes(const char *arg, vector<int> &sizes)
+{
+    sizes.clear();
+    string s = arg;
+    size_t start = 0;
+    while (start <= s.size())
+    {
+        size_t end = s.find(',', start);
+        if (end == string::npos)
+            end = s.size();
+        double v = atof(s.substr(start, end - start).c_str()); // Accepts 1e6
+        if (v >= 1 && v <= 2e9)
+            sizes.push_back((int)v);
+        start = end + 1;
+    }
+}
+
+static void parseEngines(const char *arg, bool engines[4])
+{
+    for (int e = 0; e < 4; e++)
+        engines[e] = strstr(arg, ENGINE_NAMES[e]) != nullptr;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions opt;
+    opt.sizes = {1000, 10000, 100000, 1000000};
+    for (int e = 0; e < 4; e++)
+        opt.engines[e] = true;
+    opt.probeType = 5;
+    opt.degree = 8;
+    opt.json = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--sizes") && hasValue)
+            parseSizes(argv[++i], opt.sizes);
+        else if (!strcmp(argv[i], "--engines") && hasValue)
+            parseEngines(argv[++i], opt.engines);
+        else if (!strcmp(argv[i], "--probe") && hasValue)
+            opt.probeType = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--degree") && hasValue)
+            opt.degree = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--json"))
+            opt.json = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--sizes 1e3,1e4,...] [--engines hash,heap,avl,graph] "
+                            "[--probe 0-5] [--degree d] [--json]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (!opt.json)
+        printf("%-6s %-10s %9s %12s %10s %10s %10s %9s\n",
+               "engine", "phase", "n", "ops/s", "p50 ns", "p90 ns", "p99 ns", "peak MB");
+
+    for (size_t s = 0; s < opt.sizes.size(); s++)
+    {
+        int n = opt.sizes[s];
+        if (opt.engines[0])
+            benchHash(opt, n);
+        if (opt.engines[1])
+            benchHeap(opt, n);
+        if (opt.engines[2])
+            benchAVL(opt, n);
+        if (opt.engines[3])
+            benchGraph(opt, n);
+    }
+    return 0;
+}
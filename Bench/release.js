@@ -0,0 +1,229 @@
+// Release builds of the engine modules, plus a size / startup report to pick a
+// profile per deployment (the "Build Release" and "Report Release Builds" tasks in
+// .vscode/tasks.json). Each module is rebuilt from its own emcc task, so the
+// exports stay defined in one place; only the output name and flags change:
+//
+//   o3   -O3 -flto -msimd128 -fno-exceptions   fastest code
+//   oz   -Oz -flto -msimd128 -fno-exceptions   smallest download
+//
+// both with the module's INITIAL_MEMORY below. hashtable.js becomes
+// hashtable.o3.js / hashtable.oz.js (and .wasm) next to the debug build; pages
+// load a variant with ?build=o3 or ?build=oz.
+//
+//   node release.js [--profiles o3,oz] [--modules hash,graph,graph-mt,avl,heap,combined]
+//                   [--report-only] [--runs 5] [--json]
+//
+// EMCC overrides the compiler path taken from the tasks. The report lists the .wasm
+// size raw / gzip / brotli, the glue script size, WebAssembly.compile time and the
+// time until onRuntimeInitialized in a fresh node process (median of --runs).
+
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+const zlib = require('zlib');
+const { spawnSync } = require('child_process');
+const { performance } = require('perf_hooks');
+
+const ROOT = path.resolve(__dirname, '..');
+
+// Initial linear memory per module (growth stays on). Sized for the visualizers'
+// typical inputs plus the 1 MB result ring, so a session rarely has to grow.
+const MODULES = [
+    { id: 'hash', task: 'Build Hash Table', initialMB: 16 },
+    { id: 'graph', task: 'Build Graph (WASM)', initialMB: 32 },
+    { id: 'graph-mt', task: 'Build Graph (WASM, pthreads)', initialMB: 64 },
+    { id: 'avl', task: 'Build AVL Tree', initialMB: 16 },
+    { id: 'heap', task: 'Build Binary Heap', initialMB: 16 },
+    { id: 'combined', task: 'Build Combined (WASM)', initialMB: 32 }
+];
+
+const PROFILES = {
+    o3: ['-O3'],
+    oz: ['-Oz']
+};
+const RELEASE_FLAGS = ['-flto', '-msimd128', '-fno-exceptions'];
+
+// --- Builds ---
+
+function loadTasks() {
+    const text = fs.readFileSync(path.join(ROOT, '.vscode', 'tasks.json'), 'utf8');
+    const tasks = {};
+    JSON.parse(text).tasks.forEach(t => { tasks[t.label] = t; });
+    return tasks;
+}
+
+function taskDir(task) {
+    return task.options.cwd.replace('${workspaceFolder}', ROOT);
+}
+
+function taskOutput(task) {
+    return task.args[task.args.indexOf('-o') + 1];
+}
+
+function variantName(output, profile) {
+    return output.replace(/\.js$/, '.' + profile + '.js');
+}
+
+function releaseArgs(task, mod, profile) {
+    const args = [];
+    for (let i = 0; i < task.args.length; i++) {
+        const a = task.args[i];
+        if (a === '-o') {
+            args.push('-o', variantName(task.args[++i], profile));
+        } else if (!RELEASE_FLAGS.includes(a)) {
+            args.push(a);
+        }
+    }
+    return args.concat(PROFILES[profile], RELEASE_FLAGS,
+        ['-s', 'INITIAL_MEMORY=' + mod.initialMB * 1024 * 1024]);
+}
+
+function emccFor(task) {
+    if (process.env.EMCC) return process.env.EMCC;
+    return fs.existsSync(task.command) ? task.command : 'emcc';
+}
+
+function build(task, mod, profile) {
+    const cmd = emccFor(task);
+    const args = releaseArgs(task, mod, profile);
+    console.error('[' + mod.id + ' ' + profile + '] ' + cmd + ' ' + args.join(' '));
+    // emcc.bat only runs through cmd.exe, which needs the JSON arguments quoted
+    const windows = process.platform === 'win32';
+    const result = spawnSync(cmd, windows ? args.map(a => '"' + a.replace(/"/g, '\\"') + '"') : args, {
+        cwd: taskDir(task),
+        stdio: 'inherit',
+        shell: windows
+    });
+    return result.status === 0;
+}
+
+// --- Report ---
+
+function median(values) {
+    const sorted = values.slice().sort((a, b) => a - b);
+    return sorted.length ? sorted[sorted.length >> 1] : NaN;
+}
+
+// Runs in a child process: loads one glue script and prints the time it took to
+// reach onRuntimeInitialized
+function probeStartup(jsPath) {
+    const t0 = performance.now();
+    const code = fs.readFileSync(jsPath, 'utf8');
+    const Module = {
+        print() {},
+        printErr() {},
+        onRuntimeInitialized() {
+            process.stdout.write(JSON.stringify({ startupMs: performance.now() - t0 }) + '\n');
+            process.exit(0);
+        }
+    };
+    const glue = vm.compileFunction(code, ['Module', 'require', '__dirname', '__filename', 'module', 'exports'],
+        { filename: jsPath });
+    const wrapper = { exports: {} };
+    glue(Module, require, path.dirname(jsPath), jsPath, wrapper, wrapper.exports);
+}
+
+function measureStartup(jsPath, runs) {
+    const samples = [];
+    for (let r = 0; r < runs; r++) {
+        const child = spawnSync(process.execPath, [__filename, '--probe', jsPath], { encoding: 'utf8', timeout: 30000 });
+        const line = (child.stdout || '').trim().split('\n').pop();
+        try {
+            samples.push(JSON.parse(line).startupMs);
+        } catch (e) {
+            return NaN; // e.g. the pthreads build outside a browser
+        }
+    }
+    return median(samples);
+}
+
+async function measureCompile(bytes, runs) {
+    const samples = [];
+    for (let r = 0; r < runs; r++) {
+        const t0 = performance.now();
+        await WebAssembly.compile(bytes);
+        samples.push(performance.now() - t0);
+    }
+    return median(samples);
+}
+
+async function report(task, mod, profile, opt) {
+    const jsPath = path.join(taskDir(task), variantName(taskOutput(task), profile));
+    const wasmPath = jsPath.replace(/\.js$/, '.wasm');
+    if (!fs.existsSync(jsPath) || !fs.existsSync(wasmPath)) return null;
+
+    const wasm = fs.readFileSync(wasmPath);
+    return {
+        module: mod.id,
+        profile,
+        wasmBytes: wasm.length,
+        gzipBytes: zlib.gzipSync(wasm, { level: 9 }).length,
+        brotliBytes: zlib.brotliCompressSync(wasm).length,
+        glueBytes: fs.statSync(jsPath).size,
+        compileMs: await measureCompile(wasm, opt.runs),
+        startupMs: measureStartup(jsPath, opt.runs)
+    };
+}
+
+function printRow(row, json) {
+    if (json) {
+        console.log(JSON.stringify(row));
+        return;
+    }
+    const kb = n => (n / 1024).toFixed(1);
+    const ms = n => (isNaN(n) ? 'n/a' : n.toFixed(1));
+    console.log(row.module.padEnd(9) + row.profile.padEnd(5) + kb(row.wasmBytes).padStart(10) +
+        kb(row.gzipBytes).padStart(10) + kb(row.brotliBytes).padStart(10) + kb(row.glueBytes).padStart(10) +
+        ms(row.compileMs).padStart(12) + ms(row.startupMs).padStart(12));
+}
+
+// --- Command line ---
+
+async function main(argv) {
+    if (argv[0] === '--probe') {
+        probeStartup(argv[1]);
+        return;
+    }
+
+    const opt = { profiles: Object.keys(PROFILES), modules: MODULES.map(m => m.id), build: true, runs: 5, json: false };
+    for (let i = 0; i < argv.length; i++) {
+        const hasValue = i + 1 < argv.length;
+        if (argv[i] === '--profiles' && hasValue) opt.profiles = argv[++i].split(',');
+        else if (argv[i] === '--modules' && hasValue) opt.modules = argv[++i].split(',');
+        else if (argv[i] === '--runs' && hasValue) opt.runs = Math.max(1, parseInt(argv[++i], 10) || 1);
+        else if (argv[i] === '--report-only') opt.build = false;
+        else if (argv[i] === '--json') opt.json = true;
+        else {
+            console.error('usage: node release.js [--profiles o3,oz] [--modules ' + MODULES.map(m => m.id).join(',') +
+                '] [--report-only] [--runs n] [--json]');
+            process.exit(1);
+        }
+    }
+
+    const tasks = loadTasks();
+    const selected = MODULES.filter(m => opt.modules.includes(m.id));
+    const profiles = opt.profiles.filter(p => PROFILES[p]);
+    let failed = false;
+
+    if (opt.build) {
+        for (const mod of selected)
+            for (const profile of profiles)
+                if (!build(tasks[mod.task], mod, profile)) failed = true;
+    }
+
+    if (!opt.json) {
+        console.log('module   prof   wasm KB   gzip KB    br KB   glue KB  compile ms  startup ms');
+    }
+    for (const mod of selected) {
+        for (const profile of profiles) {
+            const row = await report(tasks[mod.task], mod, profile, opt);
+            if (row) printRow(row, opt.json);
+            else console.error('[' + mod.id + ' ' + profile + '] not built');
+        }
+    }
+    if (failed) process.exit(1);
+}
+
+main(process.argv.slice(2));
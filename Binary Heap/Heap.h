@@ -0,0 +1,243 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "../Common/Stats.h"
+#include "../Common/JsonWriter.h"
+
+// Counter set the STAT_* macros below bump (Common/Stats.h)
+#undef STATS_MODULE
+#define STATS_MODULE STATS_HEAP
+
+using namespace std;
+
+// Subtrees at most this many levels deep keep their serialized JSON between calls
+static const int JSON_FRAGMENT_LEVELS = 6;
+
+// Heap order as a type: Compare()(a, b) is true when a belongs above b.
+// Each comparator gets its own Heap instantiation, so the sift loops compile to a
+// single compare with no isMin branch inside.
+struct MinCompare
+{
+    bool operator()(int a, int b) const { return a < b; }
+};
+
+struct MaxCompare
+{
+    bool operator()(int a, int b) const { return a > b; }
+};
+
+template <typename Compare>
+class Heap
+{
+    int *arr;
+    int capacity;
+    int size;
+    Compare before;
+    vector<string> fragments; // Cached JSON per slot; empty until getTreeJSON runs
+
+    // Slot i changed (value, or whether it exists): every fragment containing it is
+    // stale. A sift only moves values along one root path, so one call covers it.
+    void touchPath(int i)
+    {
+        if (fragments.empty())
+            return;
+        for (; i >= 1; i /= 2)
+        {
+            if (i < (int)fragments.size())
+                fragments[i].clear();
+        }
+    }
+
+    // Doubles the backing array (geometric growth keeps inserts amortized O(1))
+    void grow(int minCapacity)
+    {
+        int newCapacity = capacity * 2;
+        if (newCapacity < minCapacity)
+            newCapacity = minCapacity;
+        int *grown = new int[newCapacity];
+        STAT_ALLOC(newCapacity * sizeof(int));
+        memcpy(grown, arr, (size + 1) * sizeof(int));
+        delete[] arr;
+        arr = grown;
+        capacity = newCapacity;
+    }
+
+    // Iterative sift-up: parents move down into the hole, the value is written once
+    void percolateUp(int i)
+    {
+        int val = arr[i];
+        while (i > 1 && before(val, arr[i / 2])) // Root logic for 1-based indexing
+        {
+            arr[i] = arr[i / 2];
+            i /= 2;
+            STAT_INC(STAT_SIFT_STEPS);
+        }
+        arr[i] = val;
+    }
+
+    // Iterative sift-down with the same hole technique: no swaps, no recursion.
+    // Returns the slot the value settled in.
+    int percolateDown(int i)
+    {
+        int val = arr[i];
+        int lastParent = size / 2;
+        while (i <= lastParent)
+        {
+            int child = 2 * i;
+            // Branch-free pick of the better child. Without a right child the left
+            // one is compared with itself (false), so arr[size + 1] is never read.
+            int right = child + (child < size);
+            child += before(arr[right], arr[child]);
+            if (!before(arr[child], val))
+                break;
+            arr[i] = arr[child];
+            i = child;
+            STAT_INC(STAT_SIFT_STEPS);
+        }
+        arr[i] = val;
+        return i;
+    }
+
+    // Helper for JSON: nested {value, index, children} tree below slot i. Missing
+    // children are left out rather than written as null; recursion depth is log2(size).
+    // The topmost small subtree on each path is served from (or fills) fragments[];
+    // below it cache is false, so every slot is cached at most once.
+    void nodeToJSON(int i, string &out, bool cache)
+    {
+        bool small = i > (size >> JSON_FRAGMENT_LEVELS);
+        if (small && i < (int)fragments.size() && !fragments[i].empty())
+        {
+            out += fragments[i];
+            return;
+        }
+        if (!small || !cache)
+        {
+            writeNodeJSON(i, out, cache);
+            return;
+        }
+        if (i >= (int)fragments.size())
+            fragments.resize(capacity);
+        writeNodeJSON(i, fragments[i], false);
+        out += fragments[i];
+    }
+
+    void writeNodeJSON(int i, string &out, bool cache)
+    {
+        out += "{\"value\": ";
+        appendInt(out, arr[i]);
+        out += ",\"index\": "; // Useful for array visualization
+        appendInt(out, i);
+        out += ",\"children\": [";
+        if (2 * i <= size)
+            nodeToJSON(2 * i, out, cache);
+        if (2 * i + 1 <= size)
+        {
+            out += ",";
+            nodeToJSON(2 * i + 1, out, cache);
+        }
+        out += "]}";
+    }
+
+public:
+    Heap(int s)
+    {
+        capacity = s + 2; // 1-based indexing plus one spare slot past the last element
+        arr = new int[capacity];
+        STAT_ALLOC(capacity * sizeof(int));
+        size = 0;
+    }
+
+    ~Heap()
+    {
+        delete[] arr;
+    }
+
+    void insert(int val)
+    {
+        if (size + 2 >= capacity)
+            grow(size + 3);
+        size++;
+        arr[size] = val;
+        touchPath(size);
+        percolateUp(size);
+    }
+
+    // Removes the root (min or max, per Compare); -1 when empty
+    int extract()
+    {
+        if (size == 0)
+            return -1;
+        int root = arr[1];
+        arr[1] = arr[size];
+        touchPath(size);
+        size--;
+        if (size > 0)
+            touchPath(percolateDown(1));
+        return root;
+    }
+
+    // Returns the Tree Structure JSON for D3
+    string getTreeJSON()
+    {
+        if (size == 0)
+            return "null";
+        string out;
+        out.reserve(48 * (size_t)size);
+        nodeToJSON(1, out, true);
+        return out;
+    }
+
+    // Returns the flat Array JSON for the Array View
+    string getArrayJSON()
+    {
+        JsonWriter ss;
+        ss << "[";
+        for (int i = 1; i <= size; i++)
+        {
+            ss << arr[i];
+            if (i < size)
+                ss << ",";
+        }
+        ss << "]";
+        return ss.str();
+    }
+
+    // Restore heap order over the whole array (Heapify All)
+    void rebuild()
+    {
+        // Floyd's building algorithm: start from last parent down to root
+        fragments.clear();
+        for (int i = size / 2; i >= 1; i--)
+            percolateDown(i);
+    }
+
+    // Replaces the contents with vals[0..n) and heapifies them in O(n)
+    void build(const int *vals, int n)
+    {
+        if (n < 0)
+            n = 0;
+        if (n + 2 > capacity)
+            grow(n + 2);
+        if (n > 0)
+            memcpy(arr + 1, vals, n * sizeof(int));
+        size = n;
+        rebuild();
+    }
+
+    // Heap contents in array order (size() ints)
+    const int *data() { return arr + 1; }
+
+    int getSize() { return size; }
+
+    void clear()
+    {
+        size = 0;
+        fragments.clear();
+    }
+};
+
+#endif
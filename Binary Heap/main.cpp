@@ -1,7 +1,7 @@
-#include <iostream>
 #include <string>
-#include <sstream>
 #include <vector>
+#include <cstring>
+#include <chrono>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -9,279 +9,337 @@
 #define EMSCRIPTEN_KEEPALIVE
 #endif
 
+#include "Heap.h"
+#include "../Common/ResultRing.h"
+#include "../Common/Exports.h"
+#include "../Common/PriorityQueue.h"
+
 using namespace std;
 
-class Heap
+// --- Priority Queue Benchmark ---
+
+// Ids the scripted ops draw from; keys pack (distance << 16) | id so no two queued
+// keys tie and every queue goes through exactly the same states
+static const int BENCH_IDS = 1 << 16;
+
+enum BenchOpType
 {
-    int *arr;
-    int capacity;
-    int size;
+    OP_INSERT = 0,
+    OP_DECREASE = 1,
+    OP_EXTRACT = 2
+};
 
-    // Helper to swap nodes
-    void swap(int &a, int &b)
-    {
-        int temp = a;
-        a = b;
-        b = temp;
-    }
+struct BenchOp
+{
+    int type;
+    int id;
+    long long key;
+};
+
+static unsigned int benchRandom(unsigned int &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
 
-    void percolateUPMin(int i)
+// Builds a Dijkstra-like op script: new keys and lowered keys always sit above the
+// last extracted distance, so the monotone radix heap can replay it too. Roughly
+// decreasePercent of the ops are decrease-keys, the rest split between inserts and
+// extracts. counts[] receives the number of ops of each BenchOpType.
+static vector<BenchOp> makeBenchScript(int n, int decreasePercent, int counts[3])
+{
+    vector<BenchOp> ops;
+    ops.reserve(n);
+    IndexedHeap<long long, 2> ref(BENCH_IDS);
+    vector<long long> dist(BENCH_IDS, 0);
+    long long lastDist = 0;
+    unsigned int state = 0x2545F491u;
+    counts[OP_INSERT] = counts[OP_DECREASE] = counts[OP_EXTRACT] = 0;
+
+    for (int i = 0; i < n; i++)
     {
-        if (i <= 1)
-            return; // Root logic for 1-based indexing
-        int parent = i / 2;
-        if (arr[parent] > arr[i])
+        unsigned int r = benchRandom(state) % 100;
+        int type = (int)r < decreasePercent ? OP_DECREASE : ((r & 1) ? OP_INSERT : OP_EXTRACT);
+        if (type == OP_EXTRACT && ref.isEmpty())
+            type = OP_INSERT;
+
+        BenchOp op;
+        op.id = 0;
+        op.key = 0;
+        if (type != OP_EXTRACT)
         {
-            swap(arr[parent], arr[i]);
-            percolateUPMin(parent);
+            // Inserting a queued id or lowering an absent one turns into the other op
+            op.id = (int)(benchRandom(state) % BENCH_IDS);
+            if (!ref.contains(op.id))
+                type = OP_INSERT;
+            else if (dist[op.id] > lastDist + 1)
+                type = OP_DECREASE;
+            else
+                type = OP_EXTRACT;
         }
-    }
 
-    void percolateUPMax(int i)
-    {
-        if (i <= 1)
-            return;
-        int parent = i / 2;
-        if (arr[parent] < arr[i])
+        if (type == OP_INSERT)
         {
-            swap(arr[parent], arr[i]);
-            percolateUPMax(parent);
+            dist[op.id] = lastDist + 1 + benchRandom(state) % 1024;
+            op.key = (dist[op.id] << 16) | op.id;
+            ref.InsertKey(op.id, op.key);
         }
-    }
-
-    void percolateDownMin(int i)
-    {
-        int left = 2 * i;
-        int right = (2 * i) + 1;
-        int smallest = i;
-
-        if (left <= size && arr[left] < arr[smallest])
-            smallest = left;
-        if (right <= size && arr[right] < arr[smallest])
-            smallest = right;
-
-        if (smallest != i)
+        else if (type == OP_DECREASE)
+        {
+            dist[op.id] = lastDist + 1 + benchRandom(state) % (dist[op.id] - lastDist - 1);
+            op.key = (dist[op.id] << 16) | op.id;
+            ref.decreaseKey(op.id, op.key);
+        }
+        else
         {
-            swap(arr[i], arr[smallest]);
-            percolateDownMin(smallest);
+            lastDist = ref.ExtractMin().key >> 16;
         }
+        op.type = type;
+        ops.push_back(op);
+        counts[type]++;
     }
+    return ops;
+}
 
-    void percolateDownMax(int i)
+// Replays the script on one queue type. checksum folds the extracted keys in order,
+// so equal checksums mean the queues agreed on every extraction.
+template <typename PQ>
+static double replayBenchScript(const vector<BenchOp> &ops, unsigned long long &checksum)
+{
+    PQ q(BENCH_IDS);
+    checksum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < ops.size(); i++)
     {
-        int left = 2 * i;
-        int right = (2 * i) + 1;
-        int largest = i;
-
-        if (left <= size && arr[left] > arr[largest])
-            largest = left;
-        if (right <= size && arr[right] > arr[largest])
-            largest = right;
-
-        if (largest != i)
-        {
-            swap(arr[i], arr[largest]);
-            // FIX: Was recursively calling Min, changed to Max
-            percolateDownMax(largest);
-        }
+        const BenchOp &op = ops[i];
+        if (op.type == OP_INSERT)
+            q.InsertKey(op.id, op.key);
+        else if (op.type == OP_DECREASE)
+            q.decreaseKey(op.id, op.key);
+        else
+            checksum = checksum * 31 + (unsigned long long)q.ExtractMin().key;
     }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
 
-    // Helper for JSON: Converts index to recursive tree JSON
-    void nodeToJSON(int i, stringstream &ss)
+// Runs the same n-op script on every queue in Common/PriorityQueue.h. Returns
+// {"inserts":..,"decreases":..,"extracts":..,"queues":[{"name":"4-ary","ms":3.1,"nsPerOp":31.2,"agrees":true},..]}
+static string runQueueBenchmarkJSON(int n, int decreasePercent)
+{
+    if (n < 0)
+        n = 0;
+    if (decreasePercent < 0)
+        decreasePercent = 0;
+    if (decreasePercent > 100)
+        decreasePercent = 100;
+
+    int counts[3];
+    vector<BenchOp> ops = makeBenchScript(n, decreasePercent, counts);
+
+    double ms[PQ_TYPE_COUNT];
+    unsigned long long sums[PQ_TYPE_COUNT];
+    ms[PQ_BINARY] = replayBenchScript<IndexedHeap<long long, 2> >(ops, sums[PQ_BINARY]);
+    ms[PQ_DARY4] = replayBenchScript<IndexedHeap<long long, 4> >(ops, sums[PQ_DARY4]);
+    ms[PQ_DARY8] = replayBenchScript<IndexedHeap<long long, 8> >(ops, sums[PQ_DARY8]);
+    ms[PQ_PAIRING] = replayBenchScript<PairingHeap<long long> >(ops, sums[PQ_PAIRING]);
+    ms[PQ_RADIX] = replayBenchScript<RadixHeap<long long> >(ops, sums[PQ_RADIX]);
+
+    JsonWriter ss;
+    ss << "{\"inserts\":" << counts[OP_INSERT] << ",\"decreases\":" << counts[OP_DECREASE]
+       << ",\"extracts\":" << counts[OP_EXTRACT] << ",\"queues\":[";
+    for (int t = 0; t < PQ_TYPE_COUNT; t++)
     {
-        if (i > size)
-        {
-            ss << "null";
-            return;
-        }
+        if (t > 0)
+            ss << ",";
+        ss << "{\"name\":\"" << PQ_NAMES[t] << "\",\"ms\":" << ms[t]
+           << ",\"nsPerOp\":" << (n ? ms[t] * 1e6 / n : 0)
+           << ",\"agrees\":" << (sums[t] == sums[PQ_BINARY] ? "true" : "false") << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
 
-        ss << "{";
-        ss << "\"value\": " << arr[i] << ",";
-        ss << "\"index\": " << i << ","; // Useful for array visualization
-        ss << "\"children\": [";
+// --- Web Interface ---
 
-        // Left Child
-        nodeToJSON(2 * i, ss);
-        ss << ",";
-        // Right Child
-        nodeToJSON(2 * i + 1, ss);
+// One instantiation per mode; toggleMode moves the values across and heapifies
+Heap<MinCompare> *minHeap = nullptr;
+Heap<MaxCompare> *maxHeap = nullptr;
+bool isMinMode = true; // Toggle state
+// When set, insertNode/deleteNode return the nested tree JSON as they used to.
+// Off by default: the page reads the array through getHeapBuffer and builds
+// the tree from the indices itself.
+bool treeJSONMode = false;
 
-        ss << "]}";
-    }
+static string activeTreeJSON()
+{
+    return isMinMode ? minHeap->getTreeJSON() : maxHeap->getTreeJSON();
+}
 
-public:
-    Heap(int s)
-    {
-        capacity = s + 1; // 1-based indexing
-        // FIX: 'new int[capacity]' for array, not 'new int(capacity)'
-        arr = new int[capacity];
-        size = 0;
-    }
+static int activeSize()
+{
+    return isMinMode ? minHeap->getSize() : maxHeap->getSize();
+}
 
-    ~Heap()
+extern "C"
+{
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(initHeap)()
     {
-        delete[] arr;
+        delete minHeap;
+        delete maxHeap;
+        // Initial capacity 100, grows on demand
+        minHeap = new Heap<MinCompare>(100);
+        maxHeap = new Heap<MaxCompare>(100);
+        isMinMode = true;
     }
 
-    void insertMin(int val)
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(toggleMode)(int isMin)
     {
-        if (size >= capacity - 1)
-            return; // Full
-        size++;
-        arr[size] = val;
-        percolateUPMin(size);
+        STAT_TIME_SCOPE();
+        if (!minHeap)
+            ENGINE_EXPORT(initHeap)();
+        bool toMin = (isMin == 1);
+        if (toMin != isMinMode)
+        {
+            if (toMin)
+            {
+                minHeap->build(maxHeap->data(), maxHeap->getSize());
+                maxHeap->clear();
+            }
+            else
+            {
+                maxHeap->build(minHeap->data(), minHeap->getSize());
+                minHeap->clear();
+            }
+        }
+        isMinMode = toMin;
     }
 
-    void insertMax(int val)
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(insertNode)(int val)
     {
-        if (size >= capacity - 1)
-            return; // Full
-        size++;
-        arr[size] = val;
-        percolateUPMax(size);
+        STAT_TIME_SCOPE();
+        if (!minHeap)
+            ENGINE_EXPORT(initHeap)();
+
+        if (isMinMode)
+            minHeap->insert(val);
+        else
+            maxHeap->insert(val);
+
+        if (!treeJSONMode)
+            return resultRing.putString("");
+        return resultRing.putString(activeTreeJSON());
     }
 
-    // FIX: Completed logic
-    int extractMin()
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(deleteNode)(int val)
     {
-        if (size == 0)
-            return -1;
-        int root = arr[1];
-        arr[1] = arr[size];
-        size--;
-        percolateDownMin(1);
-        return root;
+        STAT_TIME_SCOPE();
+        // Note: Heaps usually only extract root (Min/Max).
+        // We will treat "deleteNode" as "Extract Root" regardless of the 'val' passed.
+        if (!minHeap)
+            return resultRing.putString("null");
+
+        if (isMinMode)
+            minHeap->extract();
+        else
+            maxHeap->extract();
+
+        if (!treeJSONMode)
+            return resultRing.putString("");
+        return resultRing.putString(activeTreeJSON());
     }
 
-    // Added Extract Max
-    int extractMax()
+    // Bulk load: replaces the heap with vals[0..n) from linear memory using
+    // Floyd's bottom-up heapify (O(n)). Returns the new size.
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(buildHeap)(const int *vals, int n)
     {
-        if (size == 0)
-            return -1;
-        int root = arr[1];
-        arr[1] = arr[size];
-        size--;
-        percolateDownMax(1);
-        return root;
+        STAT_TIME_SCOPE();
+        if (!minHeap)
+            ENGINE_EXPORT(initHeap)();
+        if (isMinMode)
+            minHeap->build(vals, n);
+        else
+            maxHeap->build(vals, n);
+        return activeSize();
     }
 
-    // Returns the Tree Structure JSON for D3
-    string getTreeJSON()
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(getHeapSize)()
     {
-        if (size == 0)
-            return "null";
-        stringstream ss;
-        nodeToJSON(1, ss);
-        return ss.str();
+        return minHeap ? activeSize() : 0;
     }
 
-    // Returns the flat Array JSON for the Array View
-    string getArrayJSON()
+    // Zero-copy view of the heap: getHeapSize() ints in level order (slot 1 first).
+    // Valid until the next mutation, since growing the heap moves the array.
+    EMSCRIPTEN_KEEPALIVE
+    const int *ENGINE_EXPORT(getHeapBuffer)()
     {
-        stringstream ss;
-        ss << "[";
-        for (int i = 1; i <= size; i++)
-        {
-            ss << arr[i];
-            if (i < size)
-                ss << ",";
-        }
-        ss << "]";
-        return ss.str();
+        if (!minHeap)
+            return nullptr;
+        return isMinMode ? minHeap->data() : maxHeap->data();
     }
 
-    // Convert current heap to Min or Max (Heapify All)
-    void rebuild(bool isMin)
+    // 1 = insertNode/deleteNode return the tree JSON, 0 = they return "" (default)
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(setTreeJSONMode)(int enabled)
     {
-        // Floyd's building algorithm: start from last parent down to root
-        for (int i = size / 2; i >= 1; i--)
-        {
-            if (isMin)
-                percolateDownMin(i);
-            else
-                percolateDownMax(i);
-        }
+        treeJSONMode = (enabled == 1);
     }
 
-    void clear() { size = 0; }
-};
-
-// --- Web Interface ---
-
-Heap *heap = nullptr;
-string buffer;
-bool isMinMode = true; // Toggle state
-
-extern "C"
-{
     EMSCRIPTEN_KEEPALIVE
-    void initHeap()
+    const char *ENGINE_EXPORT(getHeapJSON)()
     {
-        if (heap)
-            delete heap;
-        // Initialize with capacity 100
-        heap = new Heap(100);
-        isMinMode = true;
+        if (!minHeap)
+            return resultRing.putString("null");
+        return resultRing.putString(activeTreeJSON());
     }
 
+    // New: Get the flat array for visualization
     EMSCRIPTEN_KEEPALIVE
-    void toggleMode(int isMin)
+    const char *ENGINE_EXPORT(getArrayData)()
     {
-        isMinMode = (isMin == 1);
-        if (heap)
-            heap->rebuild(isMinMode);
+        if (!minHeap)
+            return resultRing.putString("[]");
+        return resultRing.putString(isMinMode ? minHeap->getArrayJSON() : maxHeap->getArrayJSON());
     }
 
+    // Times an n-op insert/decrease-key/extract mix on every priority queue
+    // variant (see runQueueBenchmarkJSON for the result shape)
     EMSCRIPTEN_KEEPALIVE
-    const char *insertNode(int val)
+    const char *ENGINE_EXPORT(runQueueBenchmark)(int n, int decreasePercent)
     {
-        if (!heap)
-            initHeap();
-
-        if (isMinMode)
-            heap->insertMin(val);
-        else
-            heap->insertMax(val);
-
-        buffer = heap->getTreeJSON();
-        return buffer.c_str();
+        return resultRing.putString(runQueueBenchmarkJSON(n, decreasePercent));
     }
 
+    // Instrumentation counters and export timings (see Common/Stats.h)
     EMSCRIPTEN_KEEPALIVE
-    const char *deleteNode(int val)
+    const char *ENGINE_EXPORT(getStats)()
     {
-        // Note: Heaps usually only extract root (Min/Max).
-        // We will treat "deleteNode" as "Extract Root" regardless of the 'val' passed.
-        if (!heap)
-            return "null";
-
-        if (isMinMode)
-            heap->extractMin();
-        else
-            heap->extractMax();
-
-        buffer = heap->getTreeJSON();
-        return buffer.c_str();
+        return resultRing.putString(statsToJSON(STATS_MODULE));
     }
 
     EMSCRIPTEN_KEEPALIVE
-    const char *getHeapJSON()
+    void ENGINE_EXPORT(resetStats)()
     {
-        if (!heap)
-            return "null";
-        buffer = heap->getTreeJSON();
-        return buffer.c_str();
+        resetEngineStats(STATS_MODULE);
     }
 
-    // New: Get the flat array for visualization
+    // Where the string exports' results live (Common/ResultRing.h); engine.js
+    // reads this once and decodes results straight out of the ring
     EMSCRIPTEN_KEEPALIVE
-    const char *getArrayData()
+    const ResultRingInfo *ENGINE_EXPORT(getResultRing)()
     {
-        if (!heap)
-            return "[]";
-        buffer = heap->getArrayJSON();
-        return buffer.c_str();
+        return resultRing.getInfo();
     }
 }
 
-int main() { return 0; }
\ No newline at end of file
+// The combined build (Combined/combined.cpp) supplies its own main
+#ifndef COMBINED_BUILD
+int main() { return 0; }
+#endif
@@ -14,7 +14,11 @@ const CONFIG = {
         stroke: "#ffffff",
         text: "#ffffff"
     },
-    nodeRadius: 20
+    nodeRadius: 20,
+    maxRenderNodes: 255,    // Larger heaps (bulk builds) only update the stats panel
+    // The tree is derived from the heap array (read through getHeapBuffer) unless
+    // the page is opened with ?tree=json, which restores the C++ tree JSON path
+    treeFromJSON: new URLSearchParams(window.location.search).get('tree') === 'json'
 };
 
 // Global State
@@ -31,8 +35,8 @@ window.onload = function () {
     initD3();
     setupEventListeners();
 
-    // Check if Module loaded fast
-    if (typeof Module !== 'undefined' && Module.runtimeInitialized) {
+    // Check if the engine loaded fast (see ../engine.js)
+    if (Engine.isReady()) {
         onReady();
     }
 
@@ -40,16 +44,17 @@ window.onload = function () {
     makeDraggable(document.getElementById('floatingConsole'), document.getElementById('dragHandle'));
 };
 
-function onReady() {
+async function onReady() {
     isWasmReady = true;
     const status = document.getElementById('systemStatus');
     if (status) status.innerHTML = '<span class="status-dot ready"></span> System: Ready';
 
-    logConsole(">> WASM Core Loaded. Binary Heap Ready.");
+    logConsole(`>> WASM Core Loaded (${Engine.mode} mode). Binary Heap Ready.`);
 
     // Initialize empty Heap in C++
     // Note: 'initHeap' is the function name in C++ now
-    Module.ccall('initHeap', null, [], []);
+    await Engine.call('initHeap', null, [], []);
+    await Engine.call('setTreeJSONMode', null, ['number'], [CONFIG.treeFromJSON ? 1 : 0]);
     updateVisuals(null);
 }
 
@@ -87,6 +92,8 @@ function setupEventListeners() {
     document.getElementById('extractBtn').onclick = handleExtract; // Renamed from delete
     document.getElementById('generateRandomBtn').onclick = handleRandom;
     document.getElementById('clearBtn').onclick = handleClear;
+    document.getElementById('buildBtn').onclick = handleBuild;
+    document.getElementById('queueBenchBtn').onclick = handleQueueBenchmark;
 
     document.getElementById('btnClearConsole').onclick = () => {
         document.getElementById('outputConsole').innerHTML = '<div class="log-entry system">>> Console Cleared.</div>';
@@ -97,21 +104,20 @@ function setupEventListeners() {
 }
 
 // 1. Toggle Min/Max
-function handleToggleMode(mode) {
+async function handleToggleMode(mode) {
     if (!isWasmReady) return;
     const type = mode === 1 ? "Min Heap" : "Max Heap";
     logConsole(`>> Switching to ${type}...`);
 
     // Call C++ to rebuild heap
-    Module.ccall('toggleMode', null, ['number'], [mode]);
+    await Engine.call('toggleMode', null, ['number'], [mode]);
 
     // Refresh view
-    const jsonStr = Module.ccall('getHeapJSON', 'string', [], []);
-    processTreeUpdate(jsonStr);
+    await processTreeUpdate();
 }
 
 // 2. Insert
-function handleInsert() {
+async function handleInsert() {
     if (!isWasmReady) return;
     const val = parseInt(document.getElementById('nodeValue').value);
 
@@ -121,19 +127,19 @@ function handleInsert() {
     }
 
     logConsole(`>> Inserting ${val}...`);
-    // Insert and get updated Tree JSON immediately
-    const jsonStr = Module.ccall('insertNode', 'string', ['number'], [val]);
-    processTreeUpdate(jsonStr);
+    // Returns the updated tree JSON only in ?tree=json mode ("" otherwise)
+    const jsonStr = await Engine.call('insertNode', 'string', ['number'], [val]);
+    await processTreeUpdate(jsonStr);
 }
 
 // 3. Extract Root
-function handleExtract() {
+async function handleExtract() {
     if (!isWasmReady) return;
     logConsole(`>> Extracting Root...`);
 
     // DeleteNode in C++ now acts as ExtractMin/Max
-    const jsonStr = Module.ccall('deleteNode', 'string', ['number'], [0]); // 0 is dummy arg
-    processTreeUpdate(jsonStr);
+    const jsonStr = await Engine.call('deleteNode', 'string', ['number'], [0]); // 0 is dummy arg
+    await processTreeUpdate(jsonStr);
 }
 
 // 4. Random
@@ -144,17 +150,77 @@ function handleRandom() {
 }
 
 // 5. Clear
-function handleClear() {
-    Module.ccall('initHeap', null, [], []);
+async function handleClear() {
+    await Engine.call('initHeap', null, [], []);
     previousNodePositions.clear();
-    processTreeUpdate("null");
+    await processTreeUpdate("null");
     logConsole(">> Heap Cleared.");
 }
 
+// 6. Bulk Build: one buildHeap call heapifies the whole array in C++
+async function handleBuild() {
+    if (!isWasmReady) return;
+    const n = parseInt(document.getElementById('bulkCount').value);
+    if (isNaN(n) || n < 1) return;
+
+    const values = new Int32Array(n);
+    for (let i = 0; i < n; i++) values[i] = Math.floor(Math.random() * 1000);
+
+    logConsole(`>> Building heap from ${n} values...`);
+    const t0 = performance.now();
+    const size = await Engine.call('buildHeap', 'number', ['int32array', 'number'], [values, n]);
+    logConsole(`Heapified ${size} values in ${(performance.now() - t0).toFixed(1)} ms.`);
+
+    previousNodePositions.clear();
+    if (size > CONFIG.maxRenderNodes) logConsole(`(Heap too large to draw; showing size only.)`);
+    await processTreeUpdate();
+}
+
+// 7. Priority queue benchmark: the same insert/decrease-key/extract script on
+// binary, 4-ary, 8-ary, pairing and radix heaps (runs in C++, nothing is drawn)
+async function handleQueueBenchmark() {
+    if (!isWasmReady) return;
+    const OPS = 200000;
+    const mixes = [0, 30, 60]; // Percent of decrease-key ops
+    logConsole(`>> Benchmarking ${OPS} ops per queue...`);
+
+    for (const pct of mixes) {
+        const res = JSON.parse(await Engine.call('runQueueBenchmark', 'string', ['number', 'number'], [OPS, pct]));
+        logConsole(`-- ${res.inserts} insert / ${res.decreases} decrease / ${res.extracts} extract --`);
+        res.queues.forEach(q => {
+            const flag = q.agrees ? "" : " (MISMATCH)";
+            logConsole(`${q.name.padEnd(8)} ${q.ms.toFixed(1)} ms, ${q.nsPerOp.toFixed(1)} ns/op${flag}`);
+        });
+    }
+}
+
 // --- Visual Updates (Tree + Array) ---
 
-function processTreeUpdate(treeJsonStr) {
+// treeJsonStr is only used in ?tree=json mode; when omitted there it is fetched
+// (skipped for heaps too large to draw)
+async function processTreeUpdate(treeJsonStr) {
+    const size = await Engine.call('getHeapSize', 'number', [], []);
+    if (size > CONFIG.maxRenderNodes) {
+        updateD3(null);
+        renderArray([]);
+        updateStats(size);
+        return;
+    }
+
+    if (!CONFIG.treeFromJSON) {
+        // Default: one view of the heap array drives both the tree and the array panel
+        const values = await Engine.viewInt32('getHeapBuffer', size);
+        currentTreeData = treeFromArray(values);
+        updateD3(currentTreeData);
+        renderArray(Array.from(values));
+        updateStats(size);
+        return;
+    }
+
     // 1. Update Tree
+    if (treeJsonStr === undefined || treeJsonStr === "") {
+        treeJsonStr = await Engine.call('getHeapJSON', 'string', [], []);
+    }
     if (treeJsonStr === "null") {
         currentTreeData = null;
         updateD3(null);
@@ -168,7 +234,7 @@ function processTreeUpdate(treeJsonStr) {
     }
 
     // 2. Update Array (Fetch separately)
-    const arrayJsonStr = Module.ccall('getArrayData', 'string', [], []);
+    const arrayJsonStr = await Engine.call('getArrayData', 'string', [], []);
     try {
         const arrayData = JSON.parse(arrayJsonStr);
         renderArray(arrayData);
@@ -178,6 +244,18 @@ function processTreeUpdate(treeJsonStr) {
     }
 }
 
+// Builds the same {value, index, children} tree getHeapJSON returns, straight from
+// the level-order array: slot i (1-based) has children 2i and 2i + 1
+function treeFromArray(values) {
+    if (!values || values.length === 0) return null;
+    const nodes = new Array(values.length);
+    for (let k = 0; k < values.length; k++) {
+        nodes[k] = { value: values[k], index: k + 1, children: [] };
+        if (k > 0) nodes[((k + 1) >> 1) - 1].children.push(nodes[k]);
+    }
+    return nodes[0];
+}
+
 // --- NEW: Array Visualization ---
 
 function renderArray(data) {
@@ -342,6 +420,7 @@ function diagonal(s, d) {
 
 function updateStats(count) {
     document.getElementById('nodeCount').innerText = count || 0;
+    Engine.renderStats(document.getElementById('engineStats'));
 }
 
 function updateVisuals(data) {
@@ -0,0 +1,83 @@
+// All four engines in one WASM module (the "Build Combined (WASM)" task in
+// .vscode/tasks.json), so the visualizers download and compile a single binary
+// that the browser can cache once. Each module's main.cpp is compiled as-is inside
+// its own namespace, with ENGINE_PREFIX renaming its exports: hash_insertValue,
+// graph_runBFS, avl_insertNode, heap_insertNode and so on. Pages opt in with
+// ?module=combined; engine.js then adds the prefix to every call.
+//
+// Everything a module includes is pulled in here first at global scope, so the
+// include guards keep those headers out of the namespaces below. The modules share
+// one result ring (Common/ResultRing.h); STATS_MODULE is set next to ENGINE_PREFIX
+// so each module's getStats / resetStats only sees its own counters.
+
+#define COMBINED_BUILD
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+#include "../Common/Stats.h"
+#include "../Common/JsonWriter.h"
+#include "../Common/PriorityQueue.h"
+#include "../Common/ResultRing.h"
+#include "../Common/Exports.h"
+#include "../Hash/HashTable.h"
+#include "../Binary Heap/Heap.h"
+#include "../AVL Tree/AVLTree.h"
+#include "../Graph/Graph.h"
+#include "../Graph/ParallelGraph.h"
+
+#undef ENGINE_PREFIX
+#define ENGINE_PREFIX hash_
+#undef STATS_MODULE
+#define STATS_MODULE STATS_HASH
+namespace hash_module
+{
+#include "../Hash/main.cpp"
+}
+
+#undef ENGINE_PREFIX
+#define ENGINE_PREFIX graph_
+#undef STATS_MODULE
+#define STATS_MODULE STATS_GRAPH
+namespace graph_module
+{
+#include "../Graph/main.cpp"
+}
+
+#undef ENGINE_PREFIX
+#define ENGINE_PREFIX avl_
+#undef STATS_MODULE
+#define STATS_MODULE STATS_AVL
+namespace avl_module
+{
+#include "../AVL Tree/main.cpp"
+}
+
+#undef ENGINE_PREFIX
+#define ENGINE_PREFIX heap_
+#undef STATS_MODULE
+#define STATS_MODULE STATS_HEAP
+namespace heap_module
+{
+#include "../Binary Heap/main.cpp"
+}
+
+int main()
+{
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef ENGINE_EXPORTS_H
+#define ENGINE_EXPORTS_H
+
+// Export naming. Standalone module builds keep the plain names. Combined/combined.cpp
+// defines ENGINE_PREFIX (hash_, graph_, avl_, heap_) around each module it pulls
+// in, so all four sets of exports can live in one WASM module; engine.js adds the
+// same prefix when a page runs on the combined build.
+#ifndef ENGINE_PREFIX
+#define ENGINE_PREFIX
+#endif
+
+#define ENGINE_PASTE_(a, b) a##b
+#define ENGINE_PASTE(a, b) ENGINE_PASTE_(a, b)
+#define ENGINE_EXPORT(name) ENGINE_PASTE(ENGINE_PREFIX, name)
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <string>
+#include <cstdio>
+
+// Append-only text builder for the JSON and traversal strings the exports return.
+// It replaces std::stringstream, which drags iostream, locales and the facet
+// machinery into every WASM binary. The << overloads print exactly what the
+// stream did: integers in decimal, doubles like the stream's default "%g"
+// (6 significant digits).
+
+// Appends the decimal form of v without going through printf
+static void appendInt(std::string &out, long long v)
+{
+    char digits[24];
+    int n = 0;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do
+    {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (v < 0)
+        out += '-';
+    while (n > 0)
+        out += digits[--n];
+}
+
+class JsonWriter
+{
+    std::string out;
+
+public:
+    JsonWriter &operator<<(const char *s)
+    {
+        out += s;
+        return *this;
+    }
+
+    JsonWriter &operator<<(const std::string &s)
+    {
+        out += s;
+        return *this;
+    }
+
+    JsonWriter &operator<<(char c)
+    {
+        out += c;
+        return *this;
+    }
+
+    JsonWriter &operator<<(int v)
+    {
+        appendInt(out, v);
+        return *this;
+    }
+
+    JsonWriter &operator<<(long v)
+    {
+        appendInt(out, v);
+        return *this;
+    }
+
+    JsonWriter &operator<<(long long v)
+    {
+        appendInt(out, v);
+        return *this;
+    }
+
+    JsonWriter &operator<<(unsigned v)
+    {
+        appendInt(out, (long long)v);
+        return *this;
+    }
+
+    JsonWriter &operator<<(double v)
+    {
+        char num[32];
+        snprintf(num, sizeof(num), "%g", v);
+        out += num;
+        return *this;
+    }
+
+    void reserve(size_t bytes) { out.reserve(bytes); }
+    const std::string &str() const { return out; }
+};
+
+#endif
@@ -0,0 +1,491 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <cstdint>
+
+// Indexed min-priority queues over ids [0, n), shared by the Graph and Binary Heap
+// modules. They all expose the same members, so algorithms take the queue as a
+// template parameter (see Graph::dijkstraWith) instead of paying for virtual calls:
+//
+//   bool isEmpty()
+//   bool contains(int v)
+//   void InsertKey(int v, T k)         ignored if v is already queued
+//   void decreaseKey(int v, T k)       ignored if v is absent or k is not smaller
+//   void InsertOrDecrease(int v, T k)
+//   HNode<T> ExtractMin()              default HNode when empty
+//
+// Every id is stored at most once; decreaseKey updates it in place.
+
+enum PQType
+{
+    PQ_BINARY = 0,  // IndexedHeap<T, 2>
+    PQ_DARY4 = 1,   // IndexedHeap<T, 4>
+    PQ_DARY8 = 2,   // IndexedHeap<T, 8>
+    PQ_PAIRING = 3, // PairingHeap<T>
+    PQ_RADIX = 4,   // RadixHeap<T>: monotone, non-negative integer keys only
+    PQ_TYPE_COUNT = 5
+};
+
+static const char *const PQ_NAMES[PQ_TYPE_COUNT] = {"binary", "4-ary", "8-ary", "pairing", "radix"};
+
+template <typename T>
+struct HNode
+{
+    int vertex;
+    T key;
+
+    HNode(int v = 0, T k = T())
+    {
+        vertex = v;
+        key = k;
+    }
+};
+
+// Indexed D-ary min-heap. pos[] maps each id to its slot (or -1), so decreaseKey
+// is a true sift-up instead of a duplicate insert.
+//
+// The slot array is shifted inside its allocation so that slot 1 (the root's first
+// child) starts a 64-byte cache line. Children of i live in D * i + 1 .. D * i + D,
+// so when D * sizeof(HNode<T>) divides 64 each child group sits in one line and a
+// sift-down level costs one miss.
+template <typename T, int D = 4>
+class IndexedHeap
+{
+private:
+    HNode<T> *storage;
+    HNode<T> *arr;
+    int *pos;
+    int size;
+    int capacity;
+
+    void place(int i, const HNode<T> &node)
+    {
+        arr[i] = node;
+        pos[node.vertex] = i;
+    }
+
+    // Hole-based sift: shift parents down instead of swapping at every level
+    void percolateUp(int i)
+    {
+        HNode<T> node = arr[i];
+        while (i > 0)
+        {
+            int parent = (i - 1) / D;
+            if (!(node.key < arr[parent].key))
+                break;
+            place(i, arr[parent]);
+            i = parent;
+        }
+        place(i, node);
+    }
+
+    void percolateDown(int i)
+    {
+        HNode<T> node = arr[i];
+        while (true)
+        {
+            int first = D * i + 1;
+            if (first >= size)
+                break;
+            int last = first + D < size ? first + D : size;
+
+            int smallest = first;
+            for (int c = first + 1; c < last; c++)
+            {
+                if (arr[c].key < arr[smallest].key)
+                    smallest = c;
+            }
+
+            if (!(arr[smallest].key < node.key))
+                break;
+            place(i, arr[smallest]);
+            i = smallest;
+        }
+        place(i, node);
+    }
+
+public:
+    IndexedHeap(int n)
+    {
+        capacity = n;
+        size = 0;
+
+        int lineSlots = (int)(64 / sizeof(HNode<T>));
+        if (lineSlots < 1)
+            lineSlots = 1;
+        storage = new HNode<T>[(n > 0 ? n : 1) + lineSlots];
+        int shift = 0;
+        while (shift < lineSlots && ((uintptr_t)(storage + shift + 1) & 63) != 0)
+            shift++;
+        arr = storage + (shift < lineSlots ? shift : 0);
+
+        pos = new int[n > 0 ? n : 1];
+        for (int i = 0; i < n; i++)
+            pos[i] = -1;
+    }
+
+    ~IndexedHeap()
+    {
+        delete[] storage;
+        delete[] pos;
+    }
+
+    bool isEmpty()
+    {
+        return size == 0;
+    }
+
+    bool contains(int v)
+    {
+        return v >= 0 && v < capacity && pos[v] != -1;
+    }
+
+    void InsertKey(int v, T k)
+    {
+        if (v < 0 || v >= capacity || size >= capacity || contains(v))
+            return;
+        arr[size] = HNode<T>(v, k);
+        pos[v] = size;
+        size++;
+        percolateUp(size - 1);
+    }
+
+    // Lowers v's key in place; ignored if v is absent or k is not smaller
+    void decreaseKey(int v, T k)
+    {
+        if (!contains(v))
+            return;
+        int i = pos[v];
+        if (!(k < arr[i].key))
+            return;
+        arr[i].key = k;
+        percolateUp(i);
+    }
+
+    void InsertOrDecrease(int v, T k)
+    {
+        if (contains(v))
+            decreaseKey(v, k);
+        else
+            InsertKey(v, k);
+    }
+
+    HNode<T> ExtractMin()
+    {
+        if (size == 0)
+            return HNode<T>();
+        HNode<T> minNode = arr[0];
+        pos[minNode.vertex] = -1;
+        size--;
+        if (size > 0)
+        {
+            place(0, arr[size]);
+            percolateDown(0);
+        }
+        return minNode;
+    }
+};
+
+// Indexed pairing heap. Nodes are preallocated per id and linked by index:
+// child[] is the leftmost child, next[]/prev[] run along the sibling list, and the
+// prev of a leftmost child is its parent. InsertKey is a single link with the root
+// and decreaseKey cuts the subtree out and links it with the root, both O(1);
+// ExtractMin does the usual two-pass pairing of the root's children.
+template <typename T>
+class PairingHeap
+{
+private:
+    T *key;
+    int *child;
+    int *next;
+    int *prev;
+    bool *queued;
+    int *pairs; // Scratch list for the first pairing pass
+    int root;
+    int count;
+    int capacity;
+
+    // Links two detached roots; the larger becomes the leftmost child of the smaller
+    int link(int a, int b)
+    {
+        if (key[b] < key[a])
+        {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        next[b] = child[a];
+        if (child[a] != -1)
+            prev[child[a]] = b;
+        prev[b] = a;
+        child[a] = b;
+        return a;
+    }
+
+public:
+    PairingHeap(int n)
+    {
+        capacity = n;
+        int slots = n > 0 ? n : 1;
+        key = new T[slots];
+        child = new int[slots];
+        next = new int[slots];
+        prev = new int[slots];
+        queued = new bool[slots];
+        pairs = new int[slots];
+        for (int i = 0; i < n; i++)
+            queued[i] = false;
+        root = -1;
+        count = 0;
+    }
+
+    ~PairingHeap()
+    {
+        delete[] key;
+        delete[] child;
+        delete[] next;
+        delete[] prev;
+        delete[] queued;
+        delete[] pairs;
+    }
+
+    bool isEmpty()
+    {
+        return count == 0;
+    }
+
+    bool contains(int v)
+    {
+        return v >= 0 && v < capacity && queued[v];
+    }
+
+    void InsertKey(int v, T k)
+    {
+        if (v < 0 || v >= capacity || queued[v])
+            return;
+        key[v] = k;
+        child[v] = next[v] = prev[v] = -1;
+        queued[v] = true;
+        count++;
+        root = root == -1 ? v : link(root, v);
+    }
+
+    // Lowers v's key in place; ignored if v is absent or k is not smaller
+    void decreaseKey(int v, T k)
+    {
+        if (!contains(v) || !(k < key[v]))
+            return;
+        key[v] = k;
+        if (v == root)
+            return;
+
+        // Cut v's subtree out of its sibling list, then relink it with the root
+        int p = prev[v];
+        if (child[p] == v)
+            child[p] = next[v];
+        else
+            next[p] = next[v];
+        if (next[v] != -1)
+            prev[next[v]] = p;
+        next[v] = prev[v] = -1;
+        root = link(root, v);
+    }
+
+    void InsertOrDecrease(int v, T k)
+    {
+        if (contains(v))
+            decreaseKey(v, k);
+        else
+            InsertKey(v, k);
+    }
+
+    HNode<T> ExtractMin()
+    {
+        if (count == 0)
+            return HNode<T>();
+        int m = root;
+
+        // Pass 1: detach the children and link them left to right in pairs
+        int pairCount = 0;
+        int c = child[m];
+        while (c != -1)
+        {
+            int a = c;
+            int b = next[a];
+            next[a] = prev[a] = -1;
+            if (b == -1)
+            {
+                pairs[pairCount++] = a;
+                break;
+            }
+            c = next[b];
+            next[b] = prev[b] = -1;
+            pairs[pairCount++] = link(a, b);
+        }
+
+        // Pass 2: fold the pairs right to left into one tree
+        root = -1;
+        if (pairCount > 0)
+        {
+            root = pairs[pairCount - 1];
+            for (int i = pairCount - 2; i >= 0; i--)
+                root = link(pairs[i], root);
+        }
+
+        child[m] = -1;
+        queued[m] = false;
+        count--;
+        return HNode<T>(m, key[m]);
+    }
+};
+
+// Indexed monotone radix heap (Ahuja, Mehlhorn, Orlin, Tarjan). Keys must be
+// non-negative integers and never drop below the last extracted key, which holds
+// for Dijkstra with non-negative weights. Bucket 0 holds keys equal to 'last';
+// bucket b > 0 holds keys whose highest bit differing from 'last' is bit b - 1.
+// Buckets are intrusive doubly linked lists, so decreaseKey is an O(1) unlink and
+// relink. A bucket is only redistributed when bucket 0 runs dry, and each key lands
+// in a strictly lower bucket every time it moves.
+template <typename T>
+class RadixHeap
+{
+private:
+    static const int BUCKETS = 65;
+
+    T *key;
+    int *next;
+    int *prev;
+    int *bucketOf; // -1 when not queued
+    int heads[BUCKETS];
+    T last;
+    int count;
+    int capacity;
+
+    int bucketIndex(T k)
+    {
+        unsigned long long diff = (unsigned long long)k ^ (unsigned long long)last;
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+    }
+
+    void push(int v)
+    {
+        int b = bucketIndex(key[v]);
+        prev[v] = -1;
+        next[v] = heads[b];
+        if (heads[b] != -1)
+            prev[heads[b]] = v;
+        heads[b] = v;
+        bucketOf[v] = b;
+    }
+
+    void unlink(int v)
+    {
+        if (prev[v] != -1)
+            next[prev[v]] = next[v];
+        else
+            heads[bucketOf[v]] = next[v];
+        if (next[v] != -1)
+            prev[next[v]] = prev[v];
+    }
+
+public:
+    RadixHeap(int n)
+    {
+        capacity = n;
+        int slots = n > 0 ? n : 1;
+        key = new T[slots];
+        next = new int[slots];
+        prev = new int[slots];
+        bucketOf = new int[slots];
+        for (int i = 0; i < n; i++)
+            bucketOf[i] = -1;
+        for (int b = 0; b < BUCKETS; b++)
+            heads[b] = -1;
+        last = T();
+        count = 0;
+    }
+
+    ~RadixHeap()
+    {
+        delete[] key;
+        delete[] next;
+        delete[] prev;
+        delete[] bucketOf;
+    }
+
+    bool isEmpty()
+    {
+        return count == 0;
+    }
+
+    bool contains(int v)
+    {
+        return v >= 0 && v < capacity && bucketOf[v] != -1;
+    }
+
+    void InsertKey(int v, T k)
+    {
+        if (v < 0 || v >= capacity || contains(v))
+            return;
+        key[v] = k;
+        push(v);
+        count++;
+    }
+
+    // Lowers v's key in place; ignored if v is absent or k is not smaller
+    void decreaseKey(int v, T k)
+    {
+        if (!contains(v) || !(k < key[v]))
+            return;
+        unlink(v);
+        key[v] = k;
+        push(v);
+    }
+
+    void InsertOrDecrease(int v, T k)
+    {
+        if (contains(v))
+            decreaseKey(v, k);
+        else
+            InsertKey(v, k);
+    }
+
+    HNode<T> ExtractMin()
+    {
+        if (count == 0)
+            return HNode<T>();
+
+        if (heads[0] == -1)
+        {
+            // Advance 'last' to the smallest key of the first non-empty bucket and
+            // spread that bucket over the lower ones
+            int b = 1;
+            while (heads[b] == -1)
+                b++;
+            T m = key[heads[b]];
+            for (int u = next[heads[b]]; u != -1; u = next[u])
+            {
+                if (key[u] < m)
+                    m = key[u];
+            }
+            last = m;
+
+            int u = heads[b];
+            heads[b] = -1;
+            while (u != -1)
+            {
+                int following = next[u];
+                push(u);
+                u = following;
+            }
+        }
+
+        int v = heads[0];
+        unlink(v);
+        bucketOf[v] = -1;
+        count--;
+        return HNode<T>(v, key[v]);
+    }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef RESULT_RING_H
+#define RESULT_RING_H
+
+#include <string>
+#include <cstring>
+
+// Shared result channel for every export that hands data back to JS. This
+// replaces the per-module std::string buffers. Results are appended to one ring
+// in linear memory as 8-byte-aligned records:
+//
+//   int32 kind    ResultKind of the payload
+//   int32 length  payload bytes, not counting the terminating NUL
+//   payload       UTF-8 text followed by a NUL
+//
+// Exports return a pointer to the payload, so ccall's 'string' return type keeps
+// working. engine.js instead reads the length from payload - 4 and decodes the
+// record in place (see getResultRing). A record stays valid until the ring wraps
+// back over it, which is never sooner than the next export call.
+
+enum ResultKind
+{
+    RESULT_UTF8 = 0
+};
+
+// Where the ring currently lives, laid out as int32s for HEAP32. Its address
+// never changes, so JS can fetch it once and re-read it after every call.
+struct ResultRingInfo
+{
+    int base;     // Address of the ring storage
+    int capacity; // Bytes
+    int head;     // Next write offset
+    int records;  // Records written so far (wraps at 2^31)
+};
+
+class ResultRing
+{
+    char *data;
+    int capacity;
+    int head;
+    ResultRingInfo info;
+
+    static int align8(int n) { return (n + 7) & ~7; }
+
+    void publish()
+    {
+        info.base = (int)(size_t)data;
+        info.capacity = capacity;
+        info.head = head;
+    }
+
+    // Room for one record of 8 + bytes; returns the payload address. Records never
+    // straddle the end: a record that does not fit restarts at offset 0, and if it
+    // is more than half the ring the ring grows first.
+    char *reserve(int kind, int length, int bytes)
+    {
+        int need = align8(8 + bytes);
+        if (need > capacity / 2)
+        {
+            int grown = capacity;
+            while (need > grown / 2)
+                grown *= 2;
+            delete[] data;
+            data = new char[grown];
+            capacity = grown;
+            head = 0;
+        }
+        if (head + need > capacity)
+            head = 0;
+
+        char *record = data + head;
+        memcpy(record, &kind, 4);
+        memcpy(record + 4, &length, 4);
+        head += need;
+        info.records++;
+        publish();
+        return record + 8;
+    }
+
+public:
+    ResultRing(int bytes = 1 << 20)
+    {
+        capacity = align8(bytes > 64 ? bytes : 64);
+        data = new char[capacity];
+        head = 0;
+        info.records = 0;
+        publish();
+    }
+
+    ~ResultRing()
+    {
+        delete[] data;
+    }
+
+    const char *putString(const char *s, int length)
+    {
+        char *out = reserve(RESULT_UTF8, length, length + 1);
+        memcpy(out, s, length);
+        out[length] = '\0';
+        return out;
+    }
+
+    const char *putString(const std::string &s)
+    {
+        return putString(s.data(), (int)s.size());
+    }
+
+    const char *putString(const char *s)
+    {
+        return putString(s, (int)strlen(s));
+    }
+
+    const ResultRingInfo *getInfo() { return &info; }
+};
+
+static ResultRing resultRing;
+
+#endif
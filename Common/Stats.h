@@ -0,0 +1,134 @@
+#ifndef ENGINE_STATS_H
+#define ENGINE_STATS_H
+
+#include <string>
+#include <cstdio>
+
+// Instrumentation counters for the four modules. Each module bumps the counters
+// that mean something for it and exposes statsToJSON() through its getStats()
+// export; counters it never touches stay 0.
+//
+// Every module keeps its own set: the STAT_* macros write to
+// engineStats[STATS_MODULE], and each module header defines STATS_MODULE before
+// its code. Combined/combined.cpp sets it again around each module's main.cpp, so
+// graph_resetStats() there leaves the hash, AVL and heap counters alone.
+//
+// Build with -DENGINE_STATS=0 to compile every STAT_* macro away. Enabled, a
+// counter bump is one add on a global and a timed export costs two clock reads.
+
+#ifndef ENGINE_STATS
+#define ENGINE_STATS 1
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h> // emscripten_get_now
+#else
+#include <chrono>
+#endif
+
+enum StatCounter
+{
+    STAT_OPS = 0,           // Timed exports run (one per STAT_TIME_SCOPE)
+    STAT_PROBES = 1,        // Hash: slots or 16-slot groups examined
+    STAT_ROTATIONS = 2,     // AVL: single rotations (a double rotation counts 2)
+    STAT_SIFT_STEPS = 3,    // Heap: levels moved by percolateUp/percolateDown
+    STAT_EDGES_RELAXED = 4, // Graph: edges scanned by Dijkstra / Prim
+    STAT_HEAP_PUSHES = 5,   // Graph: priority queue inserts and decrease-keys
+    STAT_ALLOCS = 6,        // Heap allocations of engine storage
+    STAT_ALLOC_BYTES = 7,   // Bytes requested by those allocations
+    STAT_COUNTER_COUNT = 8
+};
+
+static const char *const STAT_NAMES[STAT_COUNTER_COUNT] = {
+    "ops", "probes", "rotations", "siftSteps", "edgesRelaxed", "heapPushes", "allocs", "allocBytes"};
+
+struct EngineStats
+{
+    long long counters[STAT_COUNTER_COUNT];
+    double totalMs; // Time spent inside timed exports
+    double lastMs;  // Duration of the most recent one
+};
+
+enum StatModule
+{
+    STATS_HASH = 0,
+    STATS_GRAPH = 1,
+    STATS_AVL = 2,
+    STATS_HEAP = 3,
+    STATS_MODULE_COUNT = 4
+};
+
+static EngineStats engineStats[STATS_MODULE_COUNT];
+
+// Milliseconds from an arbitrary origin (emscripten_get_now is microsecond-grained)
+static inline double statsNowMs()
+{
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// Times one enclosing scope into totalMs / lastMs and counts it as an op
+class StatsTimer
+{
+    EngineStats &stats;
+    double start;
+
+public:
+    explicit StatsTimer(EngineStats &s) : stats(s), start(statsNowMs()) {}
+
+    ~StatsTimer()
+    {
+        double ms = statsNowMs() - start;
+        stats.totalMs += ms;
+        stats.lastMs = ms;
+        stats.counters[STAT_OPS]++;
+    }
+};
+
+static inline void resetEngineStats(StatModule module)
+{
+    EngineStats &stats = engineStats[module];
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++)
+        stats.counters[i] = 0;
+    stats.totalMs = 0;
+    stats.lastMs = 0;
+}
+
+// {"enabled":true,"ops":..,"probes":..,..,"totalMs":..,"lastMs":..}
+static inline std::string statsToJSON(StatModule module)
+{
+    const EngineStats &stats = engineStats[module];
+    std::string out = ENGINE_STATS ? "{\"enabled\":true" : "{\"enabled\":false";
+    char num[64];
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++)
+    {
+        snprintf(num, sizeof(num), "%lld", stats.counters[i]);
+        out += ",\"";
+        out += STAT_NAMES[i];
+        out += "\":";
+        out += num;
+    }
+    snprintf(num, sizeof(num), ",\"totalMs\":%.3f,\"lastMs\":%.3f}", stats.totalMs, stats.lastMs);
+    out += num;
+    return out;
+}
+
+#if ENGINE_STATS
+#define STAT_ADD(counter, n) (engineStats[STATS_MODULE].counters[counter] += (n))
+#define STAT_ALLOC(bytes) (engineStats[STATS_MODULE].counters[STAT_ALLOCS]++, \
+                           engineStats[STATS_MODULE].counters[STAT_ALLOC_BYTES] += (long long)(bytes))
+#define STAT_TIME_SCOPE() StatsTimer statsTimer(engineStats[STATS_MODULE])
+#else
+#define STAT_ADD(counter, n) ((void)0)
+#define STAT_ALLOC(bytes) ((void)0)
+#define STAT_TIME_SCOPE() ((void)0)
+#endif
+
+#define STAT_INC(counter) STAT_ADD(counter, 1)
+
+#endif
@@ -1,358 +1,493 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
-#include <iostream>
 #include <climits>
+#include "../Common/PriorityQueue.h"
+#include "../Common/Stats.h"
+
+// Counter set the STAT_* macros below bump (Common/Stats.h)
+#undef STATS_MODULE
+#define STATS_MODULE STATS_GRAPH
+
 using namespace std;
 
+// Array-backed stack. Pass the expected bound (e.g. vertex count) to avoid
+// regrowth; it doubles if pushes go past it.
 template <typename T>
-struct SNode
+class Stack
 {
-    T data;
-    SNode<T> *next;
+    T *arr;
+    int count;
+    int capacity;
 
-    SNode(T value)
+    void grow()
     {
-        data = value;
-        next = nullptr;
+        int newCapacity = capacity * 2;
+        T *newArr = new T[newCapacity];
+        for (int i = 0; i < count; i++)
+            newArr[i] = arr[i];
+        delete[] arr;
+        arr = newArr;
+        capacity = newCapacity;
     }
-};
-
-template <typename T>
-class Stack
-{
-    SNode<T> *front;
 
 public:
-    Stack()
+    Stack(int initialCapacity = 16)
     {
-        front = nullptr;
+        capacity = initialCapacity > 0 ? initialCapacity : 1;
+        count = 0;
+        arr = new T[capacity];
     }
 
     ~Stack()
     {
-        SNode<T> *currNode = front;
-        while (currNode)
-        {
-            SNode<T> *nextNode = currNode->next;
-            delete currNode;
-            currNode = nextNode;
-        }
-        front = nullptr;
+        delete[] arr;
     }
 
     void push(T v)
     {
-        SNode<T> *newNode = new SNode<T>(v);
-        if (!front)
-        {
-            front = newNode;
-            return;
-        }
-        newNode->next = front;
-        front = newNode;
+        if (count == capacity)
+            grow();
+        arr[count++] = v;
     }
 
     void pop()
     {
-        if (!front)
-            return;
-        SNode<T> *tempNode = front;
-        front = front->next;
-        delete tempNode;
+        if (count > 0)
+            count--;
     }
 
     T top()
     {
-        if (front)
-            return front->data;
+        if (count > 0)
+            return arr[count - 1];
         return T();
     }
 
     bool isEmpty()
     {
-        if (!front)
-            return true;
-        return false;
+        return count == 0;
     }
 };
 
+// Ring-buffer queue. Same sizing rule as Stack: preallocate to the known bound,
+// otherwise it doubles (unwrapping the ring) when full.
 template <typename T>
-struct QNode
+class Queue
 {
-    T data;
-    QNode<T> *next;
+    T *arr;
+    int head;
+    int count;
+    int capacity;
 
-    QNode(T value)
+    void grow()
     {
-        data = value;
-        next = nullptr;
+        int newCapacity = capacity * 2;
+        T *newArr = new T[newCapacity];
+        for (int i = 0; i < count; i++)
+            newArr[i] = arr[(head + i) % capacity];
+        delete[] arr;
+        arr = newArr;
+        head = 0;
+        capacity = newCapacity;
     }
-};
-
-template <typename T>
-class Queue
-{
-    QNode<T> *front;
-    QNode<T> *rear;
 
 public:
-    Queue()
+    Queue(int initialCapacity = 16)
     {
-        front = rear = nullptr;
+        capacity = initialCapacity > 0 ? initialCapacity : 1;
+        head = count = 0;
+        arr = new T[capacity];
     }
 
     ~Queue()
     {
-        QNode<T> *currNode = front;
-        while (currNode)
-        {
-            QNode<T> *nextNode = currNode->next;
-            delete currNode;
-            currNode = nextNode;
-        }
-        front = rear = nullptr;
+        delete[] arr;
     }
 
     void enqueue(T v)
     {
-        QNode<T> *newNode = new QNode<T>(v);
-        if (!rear)
-        {
-            front = rear = newNode;
-            return;
-        }
-        rear->next = newNode;
-        rear = newNode;
+        if (count == capacity)
+            grow();
+        int tail = head + count;
+        if (tail >= capacity)
+            tail -= capacity;
+        arr[tail] = v;
+        count++;
     }
 
     void dequeue()
     {
-        if (!front)
+        if (count == 0)
             return;
-        QNode<T> *tempNode = front;
-        front = front->next;
-        if (!front)
-            rear = nullptr;
-        delete tempNode;
+        head++;
+        if (head == capacity)
+            head = 0;
+        count--;
     }
 
     T getFront()
     {
-        if (front)
-            return front->data;
+        if (count > 0)
+            return arr[head];
         return T();
     }
 
     bool isEmpty()
     {
-        return front == nullptr;
+        return count == 0;
     }
 };
 
-template <typename T>
-struct Node
+// A single undirected edge as recorded by addEdge, kept until finalize()
+// compacts the stream into CSR form
+struct EdgeRecord
 {
-    T destination;
-    T weight;
-    Node<T> *next;
-
-    Node(T dest, T w)
-    {
-        destination = dest;
-        weight = w;
-        next = nullptr;
-    }
+    int src;
+    int dest;
+    int weight;
 };
 
-template <typename T>
-class AdjList
+// Open-addressing set of undirected edges, used for duplicate-edge checks.
+// Keys pack (min(u, v), max(u, v)) into 64 bits; capacity stays a power of two.
+class EdgeIndex
 {
-    Node<T> *front;
-    Node<T> *rear;
+    unsigned long long *keys;
+    int capacity;
+    int size;
 
-public:
-    AdjList()
-    {
-        front = rear = nullptr;
-    }
+    static const unsigned long long EMPTY = ~0ULL;
 
-    ~AdjList()
+    static unsigned long long makeKey(int u, int v)
     {
-        Node<T> *currNode = front;
-        while (currNode)
+        if (u > v)
         {
-            Node<T> *tempNode = currNode->next;
-            delete currNode;
-            currNode = tempNode;
+            int t = u;
+            u = v;
+            v = t;
         }
-        front = rear = nullptr;
+        return ((unsigned long long)(unsigned)u << 32) | (unsigned)v;
+    }
+
+    static unsigned int mix(unsigned long long k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        return (unsigned int)k;
     }
 
-    void AddEdge(T dest, T w)
+    void grow()
     {
-        Node<T> *newNode = new Node<T>(dest, w);
-        if (!front)
+        unsigned long long *oldKeys = keys;
+        int oldCapacity = capacity;
+
+        capacity *= 2;
+        keys = new unsigned long long[capacity];
+        for (int i = 0; i < capacity; i++)
+            keys[i] = EMPTY;
+
+        for (int i = 0; i < oldCapacity; i++)
         {
-            front = rear = newNode;
-            return;
+            if (oldKeys[i] == EMPTY)
+                continue;
+            unsigned int slot = mix(oldKeys[i]) & (capacity - 1);
+            while (keys[slot] != EMPTY)
+                slot = (slot + 1) & (capacity - 1);
+            keys[slot] = oldKeys[i];
         }
-        newNode->next = front;
-        front = newNode;
+        delete[] oldKeys;
     }
 
-    Node<T> *getHead()
+public:
+    EdgeIndex()
     {
-        return front;
+        capacity = 16;
+        size = 0;
+        keys = new unsigned long long[capacity];
+        for (int i = 0; i < capacity; i++)
+            keys[i] = EMPTY;
     }
-};
 
-template <typename T>
-struct HNode
-{
-    T vertex;
-    T key;
+    ~EdgeIndex()
+    {
+        delete[] keys;
+    }
 
-    HNode(T v = T(), T k = T())
+    bool contains(int u, int v)
     {
-        vertex = v;
-        key = k;
+        unsigned long long k = makeKey(u, v);
+        unsigned int slot = mix(k) & (capacity - 1);
+        while (keys[slot] != EMPTY)
+        {
+            if (keys[slot] == k)
+                return true;
+            slot = (slot + 1) & (capacity - 1);
+        }
+        return false;
+    }
+
+    // Returns false if the edge was already present
+    bool insert(int u, int v)
+    {
+        if (2 * (size + 1) > capacity)
+            grow();
+
+        unsigned long long k = makeKey(u, v);
+        unsigned int slot = mix(k) & (capacity - 1);
+        while (keys[slot] != EMPTY)
+        {
+            if (keys[slot] == k)
+                return false;
+            slot = (slot + 1) & (capacity - 1);
+        }
+        keys[slot] = k;
+        size++;
+        return true;
     }
 };
 
-template <typename T>
-class Heap
+// Graph stores edges in CSR (compressed sparse row) form:
+//   offsets[u] .. offsets[u + 1] is the slice of targets/weights holding u's neighbors.
+// addEdge only appends to an edge stream; finalize() builds the CSR arrays in one pass.
+// Each row is filled newest-edge-first, the same neighbor order the old linked AdjList gave.
+// There is no dense adjacency matrix by default; getAdjMatrix() builds one on demand.
+class Graph
 {
-private:
-    HNode<T> *arr;
-    int size;
-    int capacity;
+    int vertices;
 
-    void percolateDown(int i)
-    {
-        int left = 2 * i;
-        int right = 2 * i + 1;
-        int smallest = i;
+    EdgeRecord *edges;
+    int edgeCount;
+    int edgeCapacity;
 
-        if (left <= size && arr[left].key < arr[smallest].key)
-            smallest = left;
+    int *offsets;
+    int *targets;
+    int *weights;
+    bool finalized;
 
-        if (right <= size && arr[right].key < arr[smallest].key)
-            smallest = right;
+    EdgeIndex edgeIndex;
 
-        if (smallest != i)
-        {
-            HNode<T> temp = arr[i];
-            arr[i] = arr[smallest];
-            arr[smallest] = temp;
-            percolateDown(smallest);
-        }
+    // Lazily built V x V weight matrix (row-major), nullptr until requested
+    int *AdjMat;
+
+    void growEdges(int minCapacity)
+    {
+        int newCapacity = edgeCapacity ? edgeCapacity : 16;
+        while (newCapacity < minCapacity)
+            newCapacity *= 2;
+
+        EdgeRecord *newEdges = new EdgeRecord[newCapacity];
+        STAT_ALLOC(newCapacity * sizeof(EdgeRecord));
+        for (int i = 0; i < edgeCount; i++)
+            newEdges[i] = edges[i];
+        delete[] edges;
+        edges = newEdges;
+        edgeCapacity = newCapacity;
     }
 
-    void percolateUp(int i)
+    void ensureFinalized()
     {
-        int parent = i / 2;
-        while (i > 1 && arr[i].key < arr[parent].key)
-        {
-            HNode<T> temp = arr[i];
-            arr[i] = arr[parent];
-            arr[parent] = temp;
-            i = parent;
-            parent = i / 2;
-        }
+        if (!finalized)
+            finalize();
     }
 
 public:
-    Heap(int cap)
+    Graph(int v)
     {
-        capacity = cap;
-        size = 0;
-        arr = new HNode<T>[capacity + 1];
+        vertices = v;
+        edges = nullptr;
+        edgeCount = edgeCapacity = 0;
+        offsets = new int[v + 1];
+        STAT_ALLOC((v + 1) * sizeof(int));
+        for (int i = 0; i <= v; i++)
+            offsets[i] = 0;
+        targets = weights = nullptr;
+        finalized = true;
+        AdjMat = nullptr;
     }
 
-    ~Heap()
+    ~Graph()
     {
-        delete[] arr;
+        delete[] edges;
+        delete[] offsets;
+        delete[] targets;
+        delete[] weights;
+        delete[] AdjMat;
     }
 
-    bool isEmpty()
+    // Graphs up to this many vertices get a dense matrix without asking for it explicitly
+    static const int DENSE_MATRIX_LIMIT = 1024;
+
+    // Adds an undirected edge. Duplicates (in either direction) are ignored so the
+    // first weight wins, matching what the visualizer draws. Returns true if added.
+    bool addEdge(int src, int dest, int w)
     {
-        return size == 0;
+        if (src >= 0 && src < vertices && dest >= 0 && dest < vertices)
+        {
+            if (!edgeIndex.insert(src, dest))
+                return false;
+
+            if (edgeCount == edgeCapacity)
+                growEdges(edgeCount + 1);
+            edges[edgeCount].src = src;
+            edges[edgeCount].dest = dest;
+            edges[edgeCount].weight = w;
+            edgeCount++;
+            finalized = false;
+
+            if (AdjMat)
+            {
+                AdjMat[src * vertices + dest] = w;
+                AdjMat[dest * vertices + src] = w;
+            }
+            return true;
+        }
+        return false;
     }
 
-    void InsertKey(T v, T k)
+    // Bulk version of addEdge for packed (src, dest, weight) int triplets.
+    // Reserves the edge stream once, skips out-of-range or duplicate edges,
+    // and builds the CSR arrays straight away. Returns the number of edges added.
+    int addEdges(const int *triplets, int count)
     {
-        if (size >= capacity)
-            return;
-        size++;
-        arr[size] = HNode<T>(v, k);
-        percolateUp(size);
+        if (!triplets || count <= 0)
+            return 0;
+
+        if (edgeCount + count > edgeCapacity)
+            growEdges(edgeCount + count);
+
+        int added = 0;
+        const int *end = triplets + 3 * count;
+        for (const int *t = triplets; t < end; t += 3)
+        {
+            int src = t[0];
+            int dest = t[1];
+            if ((unsigned)src >= (unsigned)vertices || (unsigned)dest >= (unsigned)vertices)
+                continue;
+            if (!edgeIndex.insert(src, dest))
+                continue;
+
+            edges[edgeCount].src = src;
+            edges[edgeCount].dest = dest;
+            edges[edgeCount].weight = t[2];
+            edgeCount++;
+            added++;
+        }
+
+        if (added > 0)
+        {
+            delete[] AdjMat;
+            AdjMat = nullptr;
+            finalize();
+        }
+        return added;
     }
 
-    HNode<T> ExtractMin()
+    bool hasEdge(int src, int dest)
     {
-        if (size == 0)
-            return HNode<T>();
-        HNode<T> minNode = arr[1];
-        arr[1] = arr[size];
-        size--;
-        percolateDown(1);
-        return minNode;
+        if (src < 0 || src >= vertices || dest < 0 || dest >= vertices)
+            return false;
+        return edgeIndex.contains(src, dest);
     }
-};
 
-class Graph
-{
-    int vertices;
-    AdjList<int> *array;
-    int **AdjMat;
-
-public:
-    Graph(int v)
+    // Returns the V x V weight matrix (0 = no edge), building it on first use.
+    // Large graphs return nullptr unless force is set, since the matrix is O(V^2).
+    int *getAdjMatrix(bool force = false)
     {
-        vertices = v;
-        array = new AdjList<int>[v];
-        AdjMat = new int *[v];
+        if (AdjMat)
+            return AdjMat;
+        if (vertices > DENSE_MATRIX_LIMIT && !force)
+            return nullptr;
 
-        for (int i = 0; i < v; i++)
+        long long cells = (long long)vertices * vertices;
+        AdjMat = new int[cells > 0 ? cells : 1];
+        STAT_ALLOC((cells > 0 ? cells : 1) * sizeof(int));
+        for (long long i = 0; i < cells; i++)
+            AdjMat[i] = 0;
+        for (int i = 0; i < edgeCount; i++)
         {
-            AdjMat[i] = new int[v];
-            for (int j = 0; j < v; j++)
-            {
-                AdjMat[i][j] = 0;
-            }
+            AdjMat[edges[i].src * vertices + edges[i].dest] = edges[i].weight;
+            AdjMat[edges[i].dest * vertices + edges[i].src] = edges[i].weight;
         }
+        return AdjMat;
     }
 
-    ~Graph()
+    // Builds the CSR arrays from the edge stream. Called lazily by the algorithms,
+    // but can be invoked once up front after a batch of addEdge calls.
+    void finalize()
     {
-        delete[] array;
+        for (int i = 0; i <= vertices; i++)
+            offsets[i] = 0;
+
+        // Degree count (shifted by one so the prefix sum lands on row starts)
+        for (int i = 0; i < edgeCount; i++)
+        {
+            offsets[edges[i].src + 1]++;
+            offsets[edges[i].dest + 1]++;
+        }
+        for (int i = 0; i < vertices; i++)
+            offsets[i + 1] += offsets[i];
+
+        delete[] targets;
+        delete[] weights;
+        int slots = offsets[vertices];
+        targets = new int[slots > 0 ? slots : 1];
+        weights = new int[slots > 0 ? slots : 1];
+        STAT_ALLOC(2 * (slots > 0 ? slots : 1) * sizeof(int));
+
+        int *cursor = new int[vertices];
         for (int i = 0; i < vertices; i++)
+            cursor[i] = offsets[i];
+
+        // Walk the stream backwards so the most recent edge comes first in each row
+        for (int i = edgeCount - 1; i >= 0; i--)
         {
-            delete[] AdjMat[i];
+            int u = edges[i].src;
+            int v = edges[i].dest;
+            int w = edges[i].weight;
+
+            targets[cursor[u]] = v;
+            weights[cursor[u]] = w;
+            cursor[u]++;
+
+            targets[cursor[v]] = u;
+            weights[cursor[v]] = w;
+            cursor[v]++;
         }
-        delete[] AdjMat;
+        delete[] cursor;
+
+        finalized = true;
     }
 
-    void addEdge(int src, int dest, int w)
+    // Read-only CSR views for the parallel algorithms in ParallelGraph.h
+    int vertexCount() { return vertices; }
+    const int *csrOffsets()
     {
-        if (src >= 0 && src < vertices && dest >= 0 && dest < vertices)
-        {
-            array[src].AddEdge(dest, w);
-            array[dest].AddEdge(src, w);
-            AdjMat[src][dest] = w;
-            AdjMat[dest][src] = w;
-        }
+        ensureFinalized();
+        return offsets;
+    }
+    const int *csrTargets()
+    {
+        ensureFinalized();
+        return targets;
+    }
+    const int *csrWeights()
+    {
+        ensureFinalized();
+        return weights;
     }
 
     // BFS - Fills buffer with traversal order
     void BFS(int startIndex, int *buffer)
     {
+        ensureFinalized();
+
         bool *visited = new bool[vertices];
         for (int i = 0; i < vertices; i++)
             visited[i] = false;
 
-        Queue<int> q;
+        // Every vertex is enqueued at most once, so V slots never regrow
+        Queue<int> q(vertices);
         visited[startIndex] = true;
         q.enqueue(startIndex);
 
@@ -364,28 +499,136 @@ public:
             buffer[count++] = currVertex;
             q.dequeue();
 
-            Node<int> *temp = array[currVertex].getHead();
-            while (temp)
+            for (int e = offsets[currVertex]; e < offsets[currVertex + 1]; e++)
             {
-                int adjVertex = temp->destination;
+                int adjVertex = targets[e];
                 if (!visited[adjVertex])
                 {
                     visited[adjVertex] = true;
                     q.enqueue(adjVertex);
                 }
-                temp = temp->next;
             }
         }
         delete[] visited;
     }
 
+    static const int BFS_TOP_DOWN = 0;
+    static const int BFS_BOTTOM_UP = 1;
+
+    // Direction-optimizing BFS (Beamer et al.). Each level is expanded either
+    // top-down (scan the frontier's edges) or bottom-up (every unvisited vertex
+    // scans its edges for a frontier parent), whichever is cheaper at that point.
+    //
+    // buffer receives the same vertex set, level by level, as BFS(). Within a
+    // top-down level vertices appear in discovery order exactly like BFS();
+    // within a bottom-up level they appear in ascending id order. Either way the
+    // order is a valid BFS level order. levelInfo receives (direction, size)
+    // pairs per level, so it needs room for 2 * vertices ints.
+    // Returns the number of levels.
+    int BFSHybrid(int startIndex, int *buffer, int *levelInfo)
+    {
+        ensureFinalized();
+
+        // Switch thresholds from the paper: go bottom-up once the frontier's edges
+        // exceed 1/ALPHA of the unexplored edges, back to top-down once the
+        // frontier shrinks below V / BETA vertices.
+        const long long ALPHA = 14;
+        const long long BETA = 24;
+
+        int words = (vertices + 31) / 32;
+        unsigned int *frontierBits = new unsigned int[words > 0 ? words : 1];
+        bool *visited = new bool[vertices];
+        for (int i = 0; i < vertices; i++)
+            visited[i] = false;
+
+        // buffer doubles as the frontier queue: [levelStart, levelEnd) is the current level
+        int levelStart = 0;
+        int levelEnd = 1;
+        buffer[0] = startIndex;
+        visited[startIndex] = true;
+
+        long long unexploredEdges = offsets[vertices] - (offsets[startIndex + 1] - offsets[startIndex]);
+        int direction = BFS_TOP_DOWN;
+        int levels = 0;
+
+        while (levelStart < levelEnd)
+        {
+            int frontierSize = levelEnd - levelStart;
+            long long frontierEdges = 0;
+            for (int i = levelStart; i < levelEnd; i++)
+                frontierEdges += offsets[buffer[i] + 1] - offsets[buffer[i]];
+
+            if (direction == BFS_TOP_DOWN && frontierEdges * ALPHA > unexploredEdges)
+                direction = BFS_BOTTOM_UP;
+            else if (direction == BFS_BOTTOM_UP && (long long)frontierSize * BETA < vertices)
+                direction = BFS_TOP_DOWN;
+
+            levelInfo[2 * levels] = direction;
+            levelInfo[2 * levels + 1] = frontierSize;
+            levels++;
+
+            int count = levelEnd;
+            if (direction == BFS_TOP_DOWN)
+            {
+                for (int i = levelStart; i < levelEnd; i++)
+                {
+                    int u = buffer[i];
+                    for (int e = offsets[u]; e < offsets[u + 1]; e++)
+                    {
+                        int v = targets[e];
+                        if (!visited[v])
+                        {
+                            visited[v] = true;
+                            buffer[count++] = v;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                for (int w = 0; w < words; w++)
+                    frontierBits[w] = 0;
+                for (int i = levelStart; i < levelEnd; i++)
+                    frontierBits[buffer[i] >> 5] |= 1u << (buffer[i] & 31);
+
+                for (int v = 0; v < vertices; v++)
+                {
+                    if (visited[v])
+                        continue;
+                    for (int e = offsets[v]; e < offsets[v + 1]; e++)
+                    {
+                        int u = targets[e];
+                        if (frontierBits[u >> 5] & (1u << (u & 31)))
+                        {
+                            visited[v] = true;
+                            buffer[count++] = v;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            for (int i = levelEnd; i < count; i++)
+                unexploredEdges -= offsets[buffer[i] + 1] - offsets[buffer[i]];
+
+            levelStart = levelEnd;
+            levelEnd = count;
+        }
+
+        delete[] frontierBits;
+        delete[] visited;
+        return levels;
+    }
+
     void DFS(int startIndex, int *buffer)
     {
+        ensureFinalized();
+
         bool *visited = new bool[vertices];
         for (int i = 0; i < vertices; i++)
             visited[i] = false;
 
-        Stack<int> s;
+        Stack<int> s(vertices);
         s.push(startIndex);
 
         int count = 0;
@@ -401,15 +644,13 @@ public:
                 visited[currVertex] = true;
             }
 
-            Node<int> *temp = array[currVertex].getHead();
-            while (temp)
+            for (int e = offsets[currVertex]; e < offsets[currVertex + 1]; e++)
             {
-                int AdjVertex = temp->destination;
+                int AdjVertex = targets[e];
                 if (!visited[AdjVertex])
                 {
                     s.push(AdjVertex);
                 }
-                temp = temp->next;
             }
         }
         delete[] visited;
@@ -417,7 +658,9 @@ public:
 
     void PrimsAlgorithm(int startIndex, int *parentBuffer)
     {
-        Heap<int> h(vertices * vertices);
+        ensureFinalized();
+
+        IndexedHeap<int> h(vertices);
         int *key = new int[vertices];
         bool *visited = new bool[vertices];
 
@@ -430,6 +673,7 @@ public:
 
         key[startIndex] = 0;
         h.InsertKey(startIndex, 0);
+        STAT_INC(STAT_HEAP_PUSHES);
 
         while (!h.isEmpty())
         {
@@ -439,58 +683,97 @@ public:
             if (visited[u])
                 continue;
             visited[u] = true;
+            STAT_ADD(STAT_EDGES_RELAXED, offsets[u + 1] - offsets[u]);
 
-            Node<int> *temp = array[u].getHead();
-            while (temp)
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
             {
-                int v = temp->destination;
-                int weight = temp->weight;
+                int v = targets[e];
+                int weight = weights[e];
                 if (!visited[v] && weight < key[v])
                 {
                     key[v] = weight;
                     parentBuffer[v] = u;
-                    h.InsertKey(v, key[v]);
+                    h.InsertOrDecrease(v, key[v]);
+                    STAT_INC(STAT_HEAP_PUSHES);
                 }
-                temp = temp->next;
             }
         }
         delete[] key;
         delete[] visited;
     }
 
-    void DijkstraAlgorithm(int startIndex, int *distBuffer)
+    // Dijkstra over any queue from Common/PriorityQueue.h. The distances do not
+    // depend on the queue, only the order in which equal-distance vertices settle.
+    template <typename PQ>
+    void dijkstraWith(int startIndex, int *distBuffer)
     {
-        Heap<int> h(vertices * vertices);
+        ensureFinalized();
+
+        PQ h(vertices);
 
         for (int i = 0; i < vertices; i++)
             distBuffer[i] = INT_MAX;
 
         distBuffer[startIndex] = 0;
         h.InsertKey(startIndex, 0);
+        STAT_INC(STAT_HEAP_PUSHES);
 
         while (!h.isEmpty())
         {
             HNode<int> minNode = h.ExtractMin();
             int u = minNode.vertex;
-            int d = minNode.key;
+            STAT_ADD(STAT_EDGES_RELAXED, offsets[u + 1] - offsets[u]);
 
-            if (d > distBuffer[u])
-                continue;
-
-            Node<int> *temp = array[u].getHead();
-            while (temp)
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
             {
-                int v = temp->destination;
-                int weight = temp->weight;
+                int v = targets[e];
+                int weight = weights[e];
                 if (distBuffer[u] != INT_MAX && distBuffer[u] + weight < distBuffer[v])
                 {
                     distBuffer[v] = distBuffer[u] + weight;
-                    h.InsertKey(v, distBuffer[v]);
+                    h.InsertOrDecrease(v, distBuffer[v]);
+                    STAT_INC(STAT_HEAP_PUSHES);
                 }
-                temp = temp->next;
             }
         }
     }
+
+    bool hasNegativeWeight()
+    {
+        for (int i = 0; i < edgeCount; i++)
+        {
+            if (edges[i].weight < 0)
+                return true;
+        }
+        return false;
+    }
+
+    // queueType is a PQType. The radix heap needs monotone keys, so graphs with a
+    // negative weight fall back to the 4-ary heap.
+    void DijkstraAlgorithm(int startIndex, int *distBuffer, int queueType = PQ_DARY4)
+    {
+        if (queueType == PQ_RADIX && hasNegativeWeight())
+            queueType = PQ_DARY4;
+
+        switch (queueType)
+        {
+        case PQ_BINARY:
+            dijkstraWith<IndexedHeap<int, 2> >(startIndex, distBuffer);
+            break;
+        case PQ_DARY8:
+            dijkstraWith<IndexedHeap<int, 8> >(startIndex, distBuffer);
+            break;
+        case PQ_PAIRING:
+            dijkstraWith<PairingHeap<int> >(startIndex, distBuffer);
+            break;
+        case PQ_RADIX:
+            dijkstraWith<RadixHeap<int> >(startIndex, distBuffer);
+            break;
+        default:
+            dijkstraWith<IndexedHeap<int, 4> >(startIndex, distBuffer);
+            break;
+        }
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,333 @@
+#ifndef PARALLEL_GRAPH_H
+#define PARALLEL_GRAPH_H
+
+#include "Graph.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Threads exist natively and in the pthreads WASM build (-pthread defines
+// __EMSCRIPTEN_PTHREADS__). The plain WASM build runs everything on one thread.
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define GRAPH_HAS_THREADS 0
+#else
+#define GRAPH_HAS_THREADS 1
+#endif
+
+// Sense-reversing spin barrier. Spinning (rather than a futex wait) keeps the
+// browser main thread, which is one of the participants, from blocking.
+class SpinBarrier
+{
+    std::atomic<int> waiting;
+    std::atomic<int> generation;
+    int parties;
+
+public:
+    SpinBarrier(int n) : waiting(0), generation(0), parties(n) {}
+
+    void wait()
+    {
+        int gen = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) == parties - 1)
+        {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+        while (generation.load(std::memory_order_acquire) == gen)
+            std::this_thread::yield();
+    }
+};
+
+// Runs body(threadId) on 'threads' workers, the calling thread being worker 0
+template <typename F>
+void runOnThreads(int threads, F body)
+{
+#if GRAPH_HAS_THREADS
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(body, t);
+    body(0);
+    for (size_t i = 0; i < pool.size(); i++)
+        pool[i].join();
+#else
+    (void)threads;
+    body(0);
+#endif
+}
+
+class ParallelGraph
+{
+    Graph &graph;
+    int threads;
+
+public:
+    ParallelGraph(Graph &g, int threadCount) : graph(g)
+    {
+        threads = threadCount > 0 ? threadCount : 1;
+#if !GRAPH_HAS_THREADS
+        threads = 1;
+#endif
+    }
+
+    static bool hasThreads() { return GRAPH_HAS_THREADS != 0; }
+
+    static int defaultThreadCount()
+    {
+#if GRAPH_HAS_THREADS
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? (int)n : 1;
+#else
+        return 1;
+#endif
+    }
+
+    // Level-synchronous BFS. Each level's frontier is split into contiguous
+    // chunks; a vertex is claimed by whichever thread sets its bit in the atomic
+    // visited bitmap first. buffer receives a level order like BFSHybrid: levels
+    // are exact, the order inside a level follows thread/chunk order.
+    // Returns the number of vertices written.
+    int BFS(int startIndex, int *buffer)
+    {
+        int n = graph.vertexCount();
+        const int *offsets = graph.csrOffsets();
+        const int *targets = graph.csrTargets();
+
+        int words = (n + 31) / 32;
+        std::atomic<unsigned int> *visited = new std::atomic<unsigned int>[words > 0 ? words : 1];
+        for (int w = 0; w < words; w++)
+            visited[w].store(0, std::memory_order_relaxed);
+        visited[startIndex >> 5].store(1u << (startIndex & 31), std::memory_order_relaxed);
+
+        std::vector<std::vector<int>> local(threads);
+        SpinBarrier barrier(threads);
+
+        // Shared between workers; only worker 0 writes them, between barriers
+        int levelStart = 0;
+        int levelEnd = 1;
+        buffer[0] = startIndex;
+
+        runOnThreads(threads, [&](int t)
+        {
+            while (true)
+            {
+                int frontier = levelEnd - levelStart;
+                if (frontier <= 0)
+                    break;
+
+                int chunk = (frontier + threads - 1) / threads;
+                int lo = levelStart + t * chunk;
+                int hi = lo + chunk < levelEnd ? lo + chunk : levelEnd;
+
+                std::vector<int> &next = local[t];
+                next.clear();
+                for (int i = lo; i < hi; i++)
+                {
+                    int u = buffer[i];
+                    for (int e = offsets[u]; e < offsets[u + 1]; e++)
+                    {
+                        int v = targets[e];
+                        unsigned int bit = 1u << (v & 31);
+                        if (visited[v >> 5].load(std::memory_order_relaxed) & bit)
+                            continue;
+                        if (!(visited[v >> 5].fetch_or(bit, std::memory_order_relaxed) & bit))
+                            next.push_back(v);
+                    }
+                }
+
+                barrier.wait();
+                if (t == 0)
+                {
+                    int count = levelEnd;
+                    for (int k = 0; k < threads; k++)
+                    {
+                        for (size_t i = 0; i < local[k].size(); i++)
+                            buffer[count++] = local[k][i];
+                    }
+                    levelStart = levelEnd;
+                    levelEnd = count;
+                }
+                barrier.wait();
+            }
+        });
+
+        delete[] visited;
+        return levelEnd;
+    }
+
+    // Delta-stepping SSSP (Meyer & Sanders). Vertices sit in buckets of width
+    // delta by tentative distance; each bucket is drained by relaxing light
+    // edges (w <= delta) in parallel until it stops refilling, then its heavy
+    // edges are relaxed once. Distances are lowered with an atomic CAS-min.
+    // Assumes non-negative weights. distBuffer uses INT_MAX for unreachable,
+    // the same as DijkstraAlgorithm.
+    //
+    // Tentative distances never run more than maxWeight past the bucket being
+    // drained, so the buckets form a cyclic array of maxWeight / delta + 2 slots
+    // (bucket b lives in slot b % slots). delta is raised to at least
+    // maxWeight / MAX_DELTA_SPAN, which keeps that array small and bounds the
+    // number of buckets walked to about n * MAX_DELTA_SPAN.
+    static const int MAX_DELTA_SPAN = 64;
+
+    void DeltaStepping(int startIndex, int *distBuffer, int delta)
+    {
+        int n = graph.vertexCount();
+        const int *offsets = graph.csrOffsets();
+        const int *targets = graph.csrTargets();
+        const int *weights = graph.csrWeights();
+        int maxWeight = 0;
+        for (int e = 0; e < offsets[n]; e++)
+        {
+            if (weights[e] > maxWeight)
+                maxWeight = weights[e];
+        }
+        if (delta < maxWeight / MAX_DELTA_SPAN)
+            delta = maxWeight / MAX_DELTA_SPAN;
+        if (delta < 1)
+            delta = 1;
+        size_t slots = (size_t)(maxWeight / delta) + 2;
+
+        std::atomic<int> *dist = new std::atomic<int>[n > 0 ? n : 1];
+        int *relaxedAt = new int[n > 0 ? n : 1]; // distance whose light edges were last relaxed
+        int *heavyStamp = new int[n > 0 ? n : 1]; // bucket whose heavy pass already covered the vertex
+        for (int i = 0; i < n; i++)
+        {
+            dist[i].store(INT_MAX, std::memory_order_relaxed);
+            relaxedAt[i] = -1;
+            heavyStamp[i] = -1;
+        }
+        dist[startIndex].store(0, std::memory_order_relaxed);
+
+        std::vector<std::vector<int>> buckets(slots);
+        buckets[0].push_back(startIndex);
+        size_t pending = 1; // Entries across all slots, stale ones included
+        std::vector<std::vector<int>> local(threads);
+        std::vector<int> frontier;
+        std::vector<int> settled;
+        SpinBarrier barrier(threads);
+
+        // Control state, written by worker 0 between barriers
+        bool done = false;
+        bool heavyPhase = false;
+        size_t current = 0;
+
+        auto relax = [&](int u, bool heavy, std::vector<int> &out)
+        {
+            int du = dist[u].load(std::memory_order_relaxed);
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            {
+                int w = weights[e];
+                if ((w > delta) != heavy)
+                    continue;
+                int v = targets[e];
+                int candidate = du + w;
+                int old = dist[v].load(std::memory_order_relaxed);
+                while (candidate < old)
+                {
+                    if (dist[v].compare_exchange_weak(old, candidate, std::memory_order_relaxed))
+                    {
+                        out.push_back(v);
+                        break;
+                    }
+                }
+            }
+        };
+
+        // Worker 0 only: pick the next batch of work, or flag completion
+        auto schedule = [&]()
+        {
+            // Settled vertices still owe their heavy pass even once no entries are left
+            while (pending > 0 || !settled.empty())
+            {
+                frontier.clear();
+                std::vector<int> &bucket = buckets[current % slots];
+                pending -= bucket.size();
+                for (size_t i = 0; i < bucket.size(); i++)
+                {
+                    int v = bucket[i];
+                    int d = dist[v].load(std::memory_order_relaxed);
+                    if ((size_t)(d / delta) != current || relaxedAt[v] == d)
+                        continue;
+                    relaxedAt[v] = d;
+                    frontier.push_back(v);
+                    settled.push_back(v);
+                }
+                bucket.clear();
+
+                if (!frontier.empty())
+                {
+                    heavyPhase = false;
+                    return;
+                }
+
+                // Bucket is stable: relax heavy edges of everything it settled
+                frontier.clear();
+                for (size_t i = 0; i < settled.size(); i++)
+                {
+                    int v = settled[i];
+                    if (heavyStamp[v] != (int)current)
+                    {
+                        heavyStamp[v] = (int)current;
+                        frontier.push_back(v);
+                    }
+                }
+                settled.clear();
+                current++;
+
+                if (!frontier.empty())
+                {
+                    heavyPhase = true;
+                    return;
+                }
+            }
+            done = true;
+        };
+
+        auto collect = [&]()
+        {
+            for (int k = 0; k < threads; k++)
+            {
+                for (size_t i = 0; i < local[k].size(); i++)
+                {
+                    int v = local[k][i];
+                    size_t b = (size_t)(dist[v].load(std::memory_order_relaxed) / delta);
+                    buckets[b % slots].push_back(v);
+                    pending++;
+                }
+            }
+        };
+
+        schedule();
+        runOnThreads(threads, [&](int t)
+        {
+            while (!done)
+            {
+                int size = (int)frontier.size();
+                int chunk = (size + threads - 1) / threads;
+                int lo = t * chunk;
+                int hi = lo + chunk < size ? lo + chunk : size;
+
+                local[t].clear();
+                for (int i = lo; i < hi; i++)
+                    relax(frontier[i], heavyPhase, local[t]);
+
+                barrier.wait();
+                if (t == 0)
+                {
+                    collect();
+                    schedule();
+                }
+                barrier.wait();
+            }
+        });
+
+        for (int i = 0; i < n; i++)
+            distBuffer[i] = dist[i].load(std::memory_order_relaxed);
+
+        delete[] dist;
+        delete[] relaxedAt;
+        delete[] heavyStamp;
+    }
+};
+
+#endif
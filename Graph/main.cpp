@@ -1,15 +1,29 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
 #include "Graph.h"
+#include "ParallelGraph.h"
+#include "../Common/ResultRing.h"
+#include "../Common/Exports.h"
 
 // This pointer will hold the memory address where we put results for JS to read
 int *outputBuffer = nullptr;
+// Per-level (direction, size) pairs written by runBFSHybrid
+int *levelBuffer = nullptr;
 Graph *globalGraph = nullptr;
+// Worker count for the parallel variants (clamped to 1 in the single-threaded build)
+int threadCount = ParallelGraph::defaultThreadCount();
+// Priority queue used by runDijkstra (a PQType from Common/PriorityQueue.h)
+int queueType = PQ_DARY4;
 
 extern "C"
 {
 
     EMSCRIPTEN_KEEPALIVE
-    void initGraph(int vertices)
+    void ENGINE_EXPORT(initGraph)(int vertices)
     {
         if (globalGraph)
             delete globalGraph;
@@ -19,10 +33,14 @@ extern "C"
         if (outputBuffer)
             delete[] outputBuffer;
         outputBuffer = new int[vertices];
+
+        if (levelBuffer)
+            delete[] levelBuffer;
+        levelBuffer = new int[2 * vertices];
     }
 
     EMSCRIPTEN_KEEPALIVE
-    void addEdge(int u, int v, int w)
+    void ENGINE_EXPORT(addEdge)(int u, int v, int w)
     {
         if (globalGraph)
         {
@@ -30,43 +48,177 @@ extern "C"
         }
     }
 
+    // Reads 'count' packed (u, v, w) int triplets starting at ptr (written by JS into HEAP32)
+    // Returns how many edges were actually added
     EMSCRIPTEN_KEEPALIVE
-    int *getResultBuffer()
+    int ENGINE_EXPORT(addEdgesBulk)(int *ptr, int count)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalGraph)
+            return 0;
+        return globalGraph->addEdges(ptr, count);
+    }
+
+    // Optional: compacts the added edges into CSR form now instead of on the next run
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(finalizeGraph)()
+    {
+        STAT_TIME_SCOPE();
+        if (globalGraph)
+            globalGraph->finalize();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(hasEdge)(int u, int v)
+    {
+        if (globalGraph)
+            return globalGraph->hasEdge(u, v) ? 1 : 0;
+        return 0;
+    }
+
+    // Returns a pointer to the V x V weight matrix, or 0 if the graph is too large
+    // to materialize it and force is 0
+    EMSCRIPTEN_KEEPALIVE
+    int *ENGINE_EXPORT(getAdjMatrix)(int force)
+    {
+        if (globalGraph)
+            return globalGraph->getAdjMatrix(force == 1);
+        return nullptr;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int *ENGINE_EXPORT(getResultBuffer)()
     {
         return outputBuffer;
     }
 
     EMSCRIPTEN_KEEPALIVE
-    void runBFS(int startNode)
+    void ENGINE_EXPORT(runBFS)(int startNode)
     {
+        STAT_TIME_SCOPE();
         if (globalGraph)
             globalGraph->BFS(startNode, outputBuffer);
     }
 
+    // Direction-optimizing BFS: visit order goes to the result buffer, per-level
+    // (direction, size) pairs to the level buffer. Returns the number of levels.
     EMSCRIPTEN_KEEPALIVE
-    void runDFS(int startNode)
+    int ENGINE_EXPORT(runBFSHybrid)(int startNode)
     {
+        STAT_TIME_SCOPE();
+        if (globalGraph)
+            return globalGraph->BFSHybrid(startNode, outputBuffer, levelBuffer);
+        return 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int *ENGINE_EXPORT(getLevelBuffer)()
+    {
+        return levelBuffer;
+    }
+
+    // 1 when this module was built with -pthread, so the parallel variants really run in parallel
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(hasThreads)()
+    {
+        return ParallelGraph::hasThreads() ? 1 : 0;
+    }
+
+    // Clamped to defaultThreadCount(), the PTHREAD_POOL_SIZE of the -pthread build:
+    // asking for more would block the main thread on threads the pool can't supply
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(setThreadCount)(int n)
+    {
+        int limit = ParallelGraph::defaultThreadCount();
+        threadCount = (n > 0 && n < limit) ? n : limit;
+    }
+
+    // Level-synchronous parallel BFS. Returns the number of vertices written to the result buffer.
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(runParallelBFS)(int startNode)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalGraph)
+            return 0;
+        ParallelGraph pg(*globalGraph, threadCount);
+        return pg.BFS(startNode, outputBuffer);
+    }
+
+    // Delta-stepping shortest paths; same result buffer layout as runDijkstra.
+    // Buckets are indexed by dist / delta, so negative weights fall back to Dijkstra.
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(runDeltaStepping)(int startNode, int delta)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalGraph)
+            return;
+        if (globalGraph->hasNegativeWeight())
+        {
+            globalGraph->DijkstraAlgorithm(startNode, outputBuffer, queueType);
+            return;
+        }
+        ParallelGraph pg(*globalGraph, threadCount);
+        pg.DeltaStepping(startNode, outputBuffer, delta);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(runDFS)(int startNode)
+    {
+        STAT_TIME_SCOPE();
         if (globalGraph)
             globalGraph->DFS(startNode, outputBuffer);
     }
 
     EMSCRIPTEN_KEEPALIVE
-    void runPrims(int startNode)
+    void ENGINE_EXPORT(runPrims)(int startNode)
     {
+        STAT_TIME_SCOPE();
         if (globalGraph)
             globalGraph->PrimsAlgorithm(startNode, outputBuffer);
     }
 
+    // 0=Binary, 1=4-ary (default), 2=8-ary, 3=Pairing, 4=Radix
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(setQueueType)(int type)
+    {
+        queueType = (type >= 0 && type < PQ_TYPE_COUNT) ? type : PQ_DARY4;
+    }
+
     EMSCRIPTEN_KEEPALIVE
-    void runDijkstra(int startNode)
+    void ENGINE_EXPORT(runDijkstra)(int startNode)
     {
+        STAT_TIME_SCOPE();
         if (globalGraph)
-            globalGraph->DijkstraAlgorithm(startNode, outputBuffer);
+            globalGraph->DijkstraAlgorithm(startNode, outputBuffer, queueType);
+    }
+
+    // Instrumentation counters and export timings (see Common/Stats.h)
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(getStats)()
+    {
+        return resultRing.putString(statsToJSON(STATS_MODULE));
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(resetStats)()
+    {
+        resetEngineStats(STATS_MODULE);
+    }
+
+    // Where the string exports' results live (Common/ResultRing.h); engine.js
+    // reads this once and decodes results straight out of the ring
+    EMSCRIPTEN_KEEPALIVE
+    const ResultRingInfo *ENGINE_EXPORT(getResultRing)()
+    {
+        return resultRing.getInfo();
     }
 }
 
+// The combined build (Combined/combined.cpp) supplies its own main
+#ifndef COMBINED_BUILD
 int main()
 {
     // Main is empty, we are event-driven!
     return 0;
-}
\ No newline at end of file
+}
+#endif
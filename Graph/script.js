@@ -23,9 +23,13 @@ let canvas, ctx;
 let nodes = [];       // Visual data {id, x, y, edges: []}
 let isWeighted = true;
 let isGraphReady = false;
+let useParallel = false;  // Parallel BFS / delta-stepping (pthreads build only)
+let hasThreadsBuild = false; // Set in onReady from the loaded module
+// Labels for the PQType values accepted by setQueueType (Common/PriorityQueue.h)
+const QUEUE_NAMES = ["binary heap", "4-ary heap", "8-ary heap", "pairing heap", "radix heap"];
 
-// --- REMOVED "var Module" FROM HERE ---
-// It is already defined in index.html. We just use the global one.
+// --- All WASM calls go through Engine (../engine.js) ---
+// It hosts the module on the page or in a Web Worker (?engine=worker), so every call is async.
 
 // --- Initialization ---
 window.onload = function () {
@@ -39,6 +43,7 @@ window.onload = function () {
     // UI Event Listeners
     if (document.getElementById('btnInitGraph')) document.getElementById('btnInitGraph').onclick = initGraph;
     if (document.getElementById('btnAddEdge')) document.getElementById('btnAddEdge').onclick = addEdge;
+    if (document.getElementById('btnImportEdges')) document.getElementById('btnImportEdges').onclick = importEdgeList;
     // NEW: Listeners for Output Panel
     if (document.getElementById('btnShowAdjList')) document.getElementById('btnShowAdjList').onclick = renderAdjList;
     if (document.getElementById('btnShowAdjMatrix')) document.getElementById('btnShowAdjMatrix').onclick = renderAdjMatrix;
@@ -69,6 +74,20 @@ window.onload = function () {
         });
     }
 
+    // Parallel Toggle Logic
+    const parallelToggle = document.getElementById('toggleParallel');
+    if (parallelToggle) {
+        parallelToggle.addEventListener('change', (e) => {
+            useParallel = e.target.checked && canRunParallel();
+            if (e.target.checked && !useParallel) {
+                e.target.checked = false;
+                logConsole(">> Parallel mode unavailable (needs the pthreads build and a cross-origin isolated page). Using sequential algorithms.");
+                return;
+            }
+            logConsole(`>> Parallel mode: ${useParallel ? "On" : "Off"}`);
+        });
+    }
+
     // Algorithm Buttons (Delegation)
     document.querySelectorAll('.algo-btn').forEach(btn => {
         btn.addEventListener('click', (e) => {
@@ -80,33 +99,39 @@ window.onload = function () {
     // Initial Message
     drawPlaceholder();
 
-    // Check if Module is already ready (in case it loaded fast)
-    if (typeof Module !== 'undefined' && Module.runtimeInitialized) {
+    // Check if the engine is already ready (in case it loaded fast)
+    if (Engine.isReady()) {
         onReady();
     }
 };
 
 // Helper called when system is ready (triggered by HTML script)
-function onReady() {
+async function onReady() {
     const status = document.getElementById('systemStatus');
     if (status) {
         status.innerHTML = '<span class="status-dot ready"></span> System: Ready';
     }
-    logConsole(">> WebAssembly Core Loaded. Ready to Initialize.");
+    hasThreadsBuild = (await Engine.call('hasThreads', 'number', [], [])) === 1;
+    logConsole(`>> WebAssembly Core Loaded (${Engine.mode} mode). Ready to Initialize.`);
+}
+
+// True only when the loaded module is the pthreads build and threads can actually start
+function canRunParallel() {
+    return self.crossOriginIsolated && hasThreadsBuild;
 }
 
 // --- Core Logic ---
 
-function initGraph() {
+async function initGraph() {
     const vCount = parseInt(document.getElementById('vertexCount').value);
 
     // 1. Call C++ Backend
     try {
-        if (typeof Module === 'undefined' || typeof Module.ccall === 'undefined') {
+        if (!Engine.isReady()) {
             throw new Error("WASM not loaded");
         }
 
-        Module.ccall('initGraph', null, ['number'], [vCount]);
+        await Engine.call('initGraph', null, ['number'], [vCount]);
 
         // 2. Setup Visual Nodes (Circular Layout)
         nodes = [];
@@ -137,7 +162,7 @@ function initGraph() {
     }
 }
 
-function addEdge() {
+async function addEdge() {
     if (!isGraphReady) { alert("Please Initialize Graph first."); return; }
 
     const u = parseInt(document.getElementById('edgeSource').value);
@@ -152,7 +177,7 @@ function addEdge() {
     }
 
     // 1. Call C++
-    Module.ccall('addEdge', null, ['number', 'number', 'number'], [u, v, w]);
+    await Engine.call('addEdge', null, ['number', 'number', 'number'], [u, v, w]);
 
     // 2. Update Visuals
     // Check if edge exists to avoid visual duplicates
@@ -166,7 +191,66 @@ function addEdge() {
     logConsole(`>> Edge Added: ${u} --[${w}]--> ${v}`);
 }
 
-function runAlgorithm(type) {
+// Bulk import: edgeList is [[u, v, w], ...]. Packs everything into one Int32Array,
+// which Engine copies into WASM memory and hands to C++ in a single call.
+async function importEdges(edgeList) {
+    if (!isGraphReady) { alert("Please Initialize Graph first."); return 0; }
+    if (!edgeList || edgeList.length === 0) return 0;
+
+    const packed = new Int32Array(edgeList.length * 3);
+    edgeList.forEach((e, i) => {
+        packed[i * 3] = e[0];
+        packed[i * 3 + 1] = e[1];
+        packed[i * 3 + 2] = isWeighted ? (e[2] || 1) : 1;
+    });
+
+    // Keep a copy for the visual state: in worker mode the buffer is transferred away
+    const visual = packed.slice();
+    const added = await Engine.call('addEdgesBulk', 'number', ['int32array', 'number'], [packed, edgeList.length]);
+
+    // Mirror into the visual state (same duplicate rule as addEdge). Existing edges
+    // go into a Set keyed u * V + v, so the import stays O(V + E).
+    const V = nodes.length;
+    const seen = new Set();
+    nodes.forEach((n, u) => n.edges.forEach(e => seen.add(u * V + e.to)));
+    for (let i = 0; i < edgeList.length; i++) {
+        const u = visual[i * 3], v = visual[i * 3 + 1], w = visual[i * 3 + 2];
+        if (u < 0 || v < 0 || u >= V || v >= V) continue;
+        if (seen.has(u * V + v)) continue;
+        seen.add(u * V + v);
+        seen.add(v * V + u);
+        nodes[u].edges.push({ to: v, weight: w });
+        nodes[v].edges.push({ to: u, weight: w });
+    }
+
+    drawGraph();
+    logConsole(`>> Imported ${added} of ${edgeList.length} edges.`);
+    return added;
+}
+
+// Parses the Edge List box ("u v [w]" per line; commas also separate) and imports it
+async function importEdgeList() {
+    const text = document.getElementById('edgeListInput').value;
+    const edgeList = [];
+    const lines = text.split('\n');
+    for (let i = 0; i < lines.length; i++) {
+        const line = lines[i].trim();
+        if (!line) continue;
+        const parts = line.split(/[\s,]+/).map(p => parseInt(p));
+        if (parts.length < 2 || isNaN(parts[0]) || isNaN(parts[1])) {
+            logConsole(`>> Error: Line ${i + 1} is not "u v [w]": ${line}`);
+            return;
+        }
+        edgeList.push([parts[0], parts[1], isNaN(parts[2]) ? 1 : parts[2]]);
+    }
+    if (edgeList.length === 0) {
+        logConsole(">> Error: The edge list is empty.");
+        return;
+    }
+    await importEdges(edgeList);
+}
+
+async function runAlgorithm(type) {
     if (!isGraphReady) return;
 
     // --- Validation Checks ---
@@ -194,17 +278,21 @@ function runAlgorithm(type) {
     // --- Execution ---
     try {
         const vCount = nodes.length;
-        // 1. Get Pointer to C++ Result Array
-        const bufferPtr = Module.ccall('getResultBuffer', 'number', [], []);
+        // 1. Results are copied out of the C++ result array with readBuffer()
 
         if (type === 'bfs') {
             // A. Run C++ Logic
-            Module.ccall('runBFS', null, ['number'], [startNode]);
+            if (useParallel) {
+                await Engine.call('runParallelBFS', 'number', ['number'], [startNode]);
+                logConsole(`>> Starting parallel BFS from Node ${startNode}...`);
+            } else {
+                await Engine.call('runBFS', null, ['number'], [startNode]);
+                logConsole(`>> Starting BFS from Node ${startNode}...`);
+            }
             updateComplexity("BFS", "O(V + E)");
-            logConsole(`>> Starting BFS from Node ${startNode}...`);
 
             // B. Get Result & Show in Output Panel (FIXED)
-            const visitOrder = readBuffer(bufferPtr, vCount);
+            const visitOrder = await readBuffer('getResultBuffer', vCount);
             updateOutputPanel(`<div class="log-entry system">>> BFS Result (Order):</div><div class="log-entry">${visitOrder.join(' <span class="adj-arrow">-></span> ')}</div>`);
 
             // C. Animation
@@ -212,14 +300,35 @@ function runAlgorithm(type) {
             const snapshots = getBFSSnapshots(startNode);
             animateSnapshots(snapshots, 'bfs');
         }
+        else if (type === 'bfs-hybrid') {
+            // A. Run C++ Logic (direction-optimizing BFS)
+            const levelCount = await Engine.call('runBFSHybrid', 'number', ['number'], [startNode]);
+            updateComplexity("BFS (Hybrid)", "O(V + E)");
+            logConsole(`>> Starting direction-optimizing BFS from Node ${startNode}...`);
+
+            // B. Result: level-ordered visit order plus the direction used per level
+            const levelInfo = await readBuffer('getLevelBuffer', levelCount * 2);
+            const levels = [];
+            let total = 0;
+            for (let l = 0; l < levelCount; l++) {
+                levels.push({ direction: levelInfo[l * 2] === 1 ? 'bottom-up' : 'top-down', size: levelInfo[l * 2 + 1] });
+                total += levelInfo[l * 2 + 1];
+            }
+            const visitOrder = await readBuffer('getResultBuffer', total);
+            displayHybridLevels(visitOrder, levels);
+
+            // C. Animation (one level per frame)
+            hideDSPanel();
+            animateLevels(visitOrder, levels);
+        }
         else if (type === 'dfs') {
             // A. Run C++ Logic
-            Module.ccall('runDFS', null, ['number'], [startNode]);
+            await Engine.call('runDFS', null, ['number'], [startNode]);
             updateComplexity("DFS", "O(V + E)");
             logConsole(`>> Starting DFS from Node ${startNode}...`);
 
             // B. Get Result & Show in Output Panel (FIXED)
-            const visitOrder = readBuffer(bufferPtr, vCount);
+            const visitOrder = await readBuffer('getResultBuffer', vCount);
             updateOutputPanel(`<div class="log-entry system">>> DFS Result (Order):</div><div class="log-entry">${visitOrder.join(' <span class="adj-arrow">-></span> ')}</div>`);
 
             // C. Animation
@@ -229,19 +338,28 @@ function runAlgorithm(type) {
         }
         else if (type === 'prim') {
             hideDSPanel();
-            Module.ccall('runPrims', null, ['number'], [startNode]);
+            await Engine.call('runPrims', null, ['number'], [startNode]);
             updateComplexity("Prim's MST", "O(E log V)");
             logConsole(`>> Starting Prim's MST...`);
 
-            const parentArray = readBuffer(bufferPtr, vCount);
+            const parentArray = await readBuffer('getResultBuffer', vCount);
             animateMST(parentArray);
         }
         else if (type === 'dijkstra') {
             hideDSPanel();
-            Module.ccall('runDijkstra', null, ['number'], [startNode]);
-            updateComplexity("Dijkstra", "O(E + V log V)");
+            if (useParallel) {
+                // Bucket width: the mean edge weight is a reasonable default delta
+                await Engine.call('runDeltaStepping', null, ['number', 'number'], [startNode, averageEdgeWeight()]);
+                updateComplexity("Delta-Stepping", "O(V + E + L/Δ)");
+            } else {
+                const queueSelect = document.getElementById('queueType');
+                const queueType = queueSelect ? parseInt(queueSelect.value) : 1;
+                await Engine.call('setQueueType', null, ['number'], [queueType]);
+                await Engine.call('runDijkstra', null, ['number'], [startNode]);
+                updateComplexity(`Dijkstra (${QUEUE_NAMES[queueType]})`, "O(E + V log V)");
+            }
 
-            const distArray = readBuffer(bufferPtr, vCount);
+            const distArray = await readBuffer('getResultBuffer', vCount);
             logConsole(">> Shortest Paths Calculated.");
             displayDijkstraTable(distArray);
         }
@@ -250,6 +368,7 @@ function runAlgorithm(type) {
         console.error(e);
         logConsole(">> Algorithm Execution Failed.");
     }
+    Engine.renderStats(document.getElementById('engineStats'));
 }
 
 function animateSnapshots(snapshots, algoType) {
@@ -340,6 +459,50 @@ function animateTraversal(visitOrder) {
     nextFrame();
 }
 
+function displayHybridLevels(visitOrder, levels) {
+    let html = '<div class="log-entry system">>> Hybrid BFS Result (Level Order):</div>';
+    html += '<table class="matrix-table"><thead><tr><th>Level</th><th>Direction</th><th>Nodes</th></tr></thead><tbody>';
+
+    let offset = 0;
+    levels.forEach((level, i) => {
+        const members = visitOrder.slice(offset, offset + level.size);
+        offset += level.size;
+        html += `<tr><td>${i}</td><td>${level.direction}</td><td>${members.join(', ')}</td></tr>`;
+    });
+
+    html += '</tbody></table>';
+    updateOutputPanel(html);
+}
+
+function animateLevels(visitOrder, levels) {
+    let step = 0;
+    let offset = 0;
+
+    function nextFrame() {
+        if (step >= levels.length) {
+            logConsole(">> Traversal Complete.");
+            return;
+        }
+
+        // Previous level is done, current level is being expanded
+        nodes.forEach(n => { if (n.state === 'processing') n.state = 'visited'; });
+
+        const level = levels[step];
+        for (let i = offset; i < offset + level.size; i++) {
+            nodes[visitOrder[i]].state = 'processing';
+        }
+        logConsole(`>> Level ${step} (${level.direction}): ${visitOrder.slice(offset, offset + level.size).join(', ')}`);
+        offset += level.size;
+
+        drawGraph();
+
+        step++;
+        setTimeout(nextFrame, CONFIG.animDelay);
+    }
+
+    nextFrame();
+}
+
 function animateMST(parentArray) {
     let edgesToAnimate = [];
 
@@ -479,13 +642,17 @@ function drawPlaceholder() {
 
 // --- Helpers ---
 
-function readBuffer(ptr, length) {
-    const data = [];
-    const offset = ptr / 4;
-    for (let i = 0; i < length; i++) {
-        data.push(Module.HEAP32[offset + i]);
-    }
-    return data;
+// Copies 'length' ints from the C++ buffer returned by the export bufferFn, read
+// through a heap view (no intermediate copy in direct mode)
+async function readBuffer(bufferFn, length) {
+    const data = await Engine.viewInt32(bufferFn, length);
+    return Array.from(data);
+}
+
+function averageEdgeWeight() {
+    let total = 0, count = 0;
+    nodes.forEach(n => n.edges.forEach(e => { total += e.weight; count++; }));
+    return count > 0 ? Math.max(1, Math.round(total / count)) : 1;
 }
 
 function updateComplexity(algo, text) {
@@ -0,0 +1,1540 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <chrono>
+
+#include "../Common/Stats.h"
+#include "../Common/JsonWriter.h"
+
+// Counter set the STAT_* macros below bump (Common/Stats.h)
+#undef STATS_MODULE
+#define STATS_MODULE STATS_HASH
+
+// 16-wide control byte matching for probeType 5 (build with -msimd128 to use SIMD128)
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// Slot storage for one table, struct-of-arrays: a probe only reads 'values' and a
+// bitmap word, and chain heads are only allocated once separate chaining is used.
+// Replaces a 16-byte {value, occupied, deleted, next*} record per slot.
+struct SlotArray
+{
+    int capacity;
+    int *values;
+    unsigned *occupiedBits;
+    unsigned *deletedBits; // Tombstones: slot was occupied, keep probing past it
+    int *chainHeads;       // First pooled chain node behind the bucket's value, -1 = none
+
+    // Slots written since the last takeDirty(), for incremental table diffs
+    unsigned *dirtyBits;
+    vector<int> dirtyList;
+
+    SlotArray(int cap)
+    {
+        capacity = cap;
+        values = new int[capacity];
+        int words = (capacity + 31) / 32;
+        occupiedBits = new unsigned[words];
+        deletedBits = new unsigned[words];
+        dirtyBits = new unsigned[words];
+        STAT_ALLOC(capacity * sizeof(int) + 3 * words * sizeof(unsigned));
+        memset(dirtyBits, 0, words * sizeof(unsigned));
+        chainHeads = nullptr;
+        reset();
+    }
+
+    ~SlotArray()
+    {
+        delete[] values;
+        delete[] occupiedBits;
+        delete[] deletedBits;
+        delete[] dirtyBits;
+        delete[] chainHeads;
+    }
+
+    // Records that slot i (its value, flags or chain) changed
+    void touch(int i)
+    {
+        unsigned bit = 1u << (i & 31);
+        if (!(dirtyBits[i >> 5] & bit))
+        {
+            dirtyBits[i >> 5] |= bit;
+            dirtyList.push_back(i);
+        }
+    }
+
+    // Dirty slots in first-touched order; the caller serializes them before the
+    // next write. Clears the dirty set.
+    void takeDirty(vector<int> &out)
+    {
+        out.swap(dirtyList);
+        dirtyList.clear();
+        for (size_t k = 0; k < out.size(); k++)
+            dirtyBits[out[k] >> 5] &= ~(1u << (out[k] & 31));
+    }
+
+    void clearDirty()
+    {
+        for (size_t k = 0; k < dirtyList.size(); k++)
+            dirtyBits[dirtyList[k] >> 5] &= ~(1u << (dirtyList[k] & 31));
+        dirtyList.clear();
+    }
+
+    bool occupied(int i) const { return (occupiedBits[i >> 5] >> (i & 31)) & 1u; }
+    bool deleted(int i) const { return (deletedBits[i >> 5] >> (i & 31)) & 1u; }
+    bool empty(int i) const { return !occupied(i) && !deleted(i); }
+
+    // Stores 'value' in slot i (a fresh bucket has no chain)
+    void fill(int i, int value)
+    {
+        touch(i);
+        values[i] = value;
+        occupiedBits[i >> 5] |= 1u << (i & 31);
+        deletedBits[i >> 5] &= ~(1u << (i & 31));
+        if (chainHeads)
+            chainHeads[i] = -1;
+    }
+
+    void markDeleted(int i)
+    {
+        touch(i);
+        occupiedBits[i >> 5] &= ~(1u << (i & 31));
+        deletedBits[i >> 5] |= 1u << (i & 31);
+    }
+
+    void markEmpty(int i)
+    {
+        touch(i);
+        occupiedBits[i >> 5] &= ~(1u << (i & 31));
+        deletedBits[i >> 5] &= ~(1u << (i & 31));
+    }
+
+    // Chain head of bucket i; only meaningful while the bucket is occupied
+    int &chainHead(int i)
+    {
+        if (!chainHeads)
+        {
+            chainHeads = new int[capacity];
+            STAT_ALLOC(capacity * sizeof(int));
+            for (int j = 0; j < capacity; j++)
+                chainHeads[j] = -1;
+        }
+        return chainHeads[i];
+    }
+
+    int chainOf(int i) const
+    {
+        return (chainHeads && occupied(i)) ? chainHeads[i] : -1;
+    }
+
+    // Empties every slot. Only the bitmaps are cleared: values and chain heads are
+    // rewritten by fill() before they are read again.
+    void reset()
+    {
+        int words = (capacity + 31) / 32;
+        memset(occupiedBits, 0, words * sizeof(unsigned));
+        memset(deletedBits, 0, words * sizeof(unsigned));
+    }
+};
+
+// Separate chaining node, addressed by index into a ChainPool
+struct ChainNode
+{
+    int value;
+    int next; // -1 = end of chain
+};
+
+// Slab of chain nodes shared by the current and the draining table. Unlinked nodes
+// go on a free list; reset() drops every node at once instead of walking the chains.
+class ChainPool
+{
+private:
+    ChainNode *nodes;
+    int count;
+    int capacity;
+    int freeList;
+
+public:
+    ChainPool()
+    {
+        nodes = nullptr;
+        count = 0;
+        capacity = 0;
+        freeList = -1;
+    }
+
+    ~ChainPool()
+    {
+        delete[] nodes;
+    }
+
+    int alloc(int value, int next)
+    {
+        int n;
+        if (freeList != -1)
+        {
+            n = freeList;
+            freeList = nodes[n].next;
+        }
+        else
+        {
+            if (count == capacity)
+            {
+                int newCapacity = capacity ? capacity * 2 : 64;
+                ChainNode *grown = new ChainNode[newCapacity];
+                STAT_ALLOC(newCapacity * sizeof(ChainNode));
+                if (count)
+                    memcpy(grown, nodes, count * sizeof(ChainNode));
+                delete[] nodes;
+                nodes = grown;
+                capacity = newCapacity;
+            }
+            n = count++;
+        }
+        nodes[n].value = value;
+        nodes[n].next = next;
+        return n;
+    }
+
+    void release(int n)
+    {
+        nodes[n].next = freeList;
+        freeList = n;
+    }
+
+    void reset()
+    {
+        count = 0;
+        freeList = -1;
+    }
+
+    ChainNode &operator[](int n) { return nodes[n]; }
+};
+
+// Step statuses shared by the JSON log and the binary trace.
+// JS maps these back to the strings below (keep both in sync with Hash/script.js).
+enum StepStatus
+{
+    STEP_INSERTED = 0,
+    STEP_INSERTED_CHAIN = 1,
+    STEP_COLLISION = 2,
+    STEP_TRAVERSING = 3,
+    STEP_DUPLICATE = 4,
+    STEP_FULL = 5,
+    STEP_EMPTY = 6,
+    STEP_FOUND = 7,
+    STEP_NOT_FOUND = 8,
+    STEP_TOMBSTONE = 9, // Probed past a deleted slot
+    STEP_REMOVED = 10,  // Value deleted (index -1 if it was still in the old table)
+    STEP_RESIZE = 11,   // Rehash started: index -1, value = new capacity
+    STEP_REHASHED = 12, // Value moved from the old table to 'index' in the new one
+    STEP_SWAPPED = 13,  // Robin Hood: 'value' took this slot from a richer resident
+    STEP_SHIFTED = 14,  // Robin Hood delete: 'value' moved back into 'index'
+    STEP_GROUP = 15     // Group probe starting at 'index'; value = tag matches in the group
+};
+
+static const char *STEP_NAMES[] = {
+    "inserted", "inserted_chain", "collision", "traversing", "duplicate",
+    "full", "empty", "found", "not_found", "tombstone", "removed", "resize", "rehashed",
+    "swapped", "shifted", "group"};
+
+// One animation step, laid out as three int32s so JS can read the trace
+// straight out of HEAP32 without any parsing
+struct TraceStep
+{
+    int index;
+    int status;
+    int value;
+};
+
+// Steps that examine a slot (or a 16-slot group) count towards the probe length
+static const bool IS_PROBE_STEP[] = {
+    true, true, true, true, true,
+    false, true, true, false, true, true, false, false,
+    true, false, true};
+
+// Hash function used to pick the home bucket (initHashTable's hashType)
+enum HashType
+{
+    HASH_MODULO = 0,     // value % capacity
+    HASH_FIBONACCI = 1,  // Top bits of value * 2^32/phi; capacity is kept a power of two
+    HASH_MURMUR = 2,     // murmur3 fmix32 finalizer
+    HASH_TABULATION = 3, // XOR of four random byte tables
+    HASH_TYPE_COUNT = 4
+};
+
+static const int BATCH_HISTOGRAM_BINS = 16;
+
+// Aggregate result of insertBatch/searchBatch, laid out as int32s for HEAP32
+struct BatchStats
+{
+    int ops;
+    int failures;        // insert: table full; search: key not found
+    int maxProbe;        // Longest single probe sequence
+    int totalProbesLow;  // 64-bit total probe count, split so JS can read it as int32s
+    int totalProbesHigh;
+    int histogram[BATCH_HISTOGRAM_BINS]; // [k] = ops with k collisions; last bin = that many or more
+};
+
+static unsigned fmix32(unsigned h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Maps a 32-bit hash onto [0, cap) with a multiply instead of a division. For a
+// power-of-two cap this is exactly the top log2(cap) bits.
+static int reduceRange(unsigned h, int cap)
+{
+    return (int)(((unsigned long long)h * (unsigned)cap) >> 32);
+}
+
+static int nextPowerOfTwo(int n)
+{
+    int p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+// Control bytes for probeType 5. A full slot stores the 7-bit tag H2(value).
+static const signed char CTRL_EMPTY = -128;
+static const signed char CTRL_DELETED = -2;
+static const int GROUP_WIDTH = 16;
+
+// Bitmask of the bytes in g[0..15] equal to b
+static unsigned matchGroup(const signed char *g, signed char b)
+{
+#if defined(__wasm_simd128__)
+    v128_t group = wasm_v128_load(g);
+    return wasm_i8x16_bitmask(wasm_i8x16_eq(group, wasm_i8x16_splat(b)));
+#elif defined(__SSE2__)
+    __m128i group = _mm_loadu_si128((const __m128i *)g);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(b)));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++)
+    {
+        if (g[i] == b)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+static int lowestBit(unsigned mask)
+{
+    int i = 0;
+    while (!(mask & 1u))
+    {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+}
+
+static bool isPrime(int n)
+{
+    if (n < 2)
+        return false;
+    for (int d = 2; (long long)d * d <= n; d++)
+    {
+        if (n % d == 0)
+            return false;
+    }
+    return true;
+}
+
+static int nextPrime(int n)
+{
+    while (!isPrime(n))
+        n++;
+    return n;
+}
+
+// Open addressing (linear/quadratic/Robin Hood/group probing) or separate chaining
+// hash table.
+//
+// probeType 4 (Robin Hood) is linear probing where an insert takes the slot of any
+// resident that sits closer to its home bucket, and deletes shift the following run
+// back instead of leaving tombstones. probeType 5 keeps a one-byte control array
+// beside the slots and matches a whole group of 16 tags per probe, Swiss-table style.
+// The group sequence is linear, and the first GROUP_WIDTH control bytes are mirrored
+// past the end so a group load never wraps.
+//
+// Every capacity goes through tableSizeFor: a prime for modulo, murmur3 and
+// tabulation hashing, a power of two for Fibonacci hashing. On the power-of-two
+// tables quadratic probing steps by triangular numbers (see probeIndex).
+//
+// Growth is incremental: once (live + tombstones) / capacity passes maxLoadFactor
+// a new table (twice the size, or the same size when most of that load is
+// tombstones) is allocated and the old one is kept alongside it.
+// Every following operation migrates REHASH_BATCH old buckets, so no single insert
+// pays for the whole rehash. Lookups that hit a not-yet-migrated value move it
+// over on the spot, so every logged index refers to the new table.
+class HashTable
+{
+private:
+    SlotArray *table;
+    int capacity;
+    int size;       // Live values in both tables
+    int tombstones; // Deleted slots in 'table'
+
+    // Old table being drained during an incremental rehash (nullptr otherwise)
+    SlotArray *oldTable;
+    int migrateCursor;
+
+    ChainPool nodes; // Chain nodes of both tables
+
+    double maxLoadFactor;
+    int activeProbeType; // Probe type of the stored values; used when rehashing
+
+    // probeType 5 metadata: capacity + GROUP_WIDTH bytes, the tail mirrors the head
+    signed char *ctrl;
+
+    // Table diffs: bumps whenever getTableDelta has something new to report.
+    // fullRefresh is set when every slot changed at once (resize, clear, init).
+    int generation;
+    bool fullRefresh;
+    vector<int> deltaSlots; // Scratch for getTableDelta
+
+    bool traceEnabled; // Silent inserts (rehash migration) skip step logging
+    int probeCount;    // Probe steps taken by the last operation, logged or not
+    unsigned outcome;  // Bit (1 << status) for every step status the last operation hit
+
+    int hashType;
+    unsigned tabulation[4][256]; // HASH_TABULATION byte tables
+
+    static const int REHASH_BATCH = 4;
+
+    // Steps recorded by the last insert/search. Cleared (not freed) per operation,
+    // so steady-state tracing does no allocation.
+    vector<TraceStep> trace;
+
+    void logStep(int index, StepStatus status, int val)
+    {
+        probeCount += IS_PROBE_STEP[status];
+        STAT_ADD(STAT_PROBES, IS_PROBE_STEP[status]);
+        outcome |= 1u << status;
+        if (!traceEnabled)
+            return;
+        TraceStep step;
+        step.index = index;
+        step.status = status;
+        step.value = val;
+        trace.push_back(step);
+    }
+
+    int hashIndex(int value, int cap) const
+    {
+        unsigned x = (unsigned)value;
+        switch (hashType)
+        {
+        case HASH_FIBONACCI:
+            return reduceRange(x * 2654435769u, cap);
+        case HASH_MURMUR:
+            return reduceRange(fmix32(x), cap);
+        case HASH_TABULATION:
+            return reduceRange(tabulation[0][x & 0xFF] ^ tabulation[1][(x >> 8) & 0xFF] ^
+                                   tabulation[2][(x >> 16) & 0xFF] ^ tabulation[3][x >> 24],
+                               cap);
+        default:
+        {
+            int h = value % cap;
+            return h < 0 ? h + cap : h;
+        }
+        }
+    }
+
+    // Table sizes: powers of two for Fibonacci hashing, primes otherwise
+    int tableSizeFor(int n) const
+    {
+        return hashType == HASH_FIBONACCI ? nextPowerOfTwo(n) : nextPrime(n);
+    }
+
+    // i-th probe position: Linear (H(x) + i) % Size, Quadratic (H(x) + i*i) % Size.
+    // On power-of-two tables (Fibonacci hashing) i*i only reaches a fraction of the
+    // slots, so quadratic probing steps by the triangular numbers i*(i+1)/2 there,
+    // which visit every slot once in the first Size probes.
+    static int probeIndex(int initialIndex, int i, int probeType, int cap)
+    {
+        if (probeType == 1)
+            return (initialIndex + i) % cap;
+        if ((cap & (cap - 1)) == 0)
+            return (int)((initialIndex + (long long)i * (i + 1) / 2) & (cap - 1));
+        return (int)((initialIndex + (long long)i * i) % cap);
+    }
+
+    // Robin Hood: distance of the value stored at 'idx' from its home bucket
+    int probeDistance(int value, int idx)
+    {
+        int d = idx - hashIndex(value, capacity);
+        return d < 0 ? d + capacity : d;
+    }
+
+    // 7-bit tag kept in the control byte of a full slot. Taken from fmix32 so it
+    // stays independent of the bits that picked the home bucket.
+    static signed char tagOf(int value)
+    {
+        return (signed char)(fmix32((unsigned)value) & 0x7F);
+    }
+
+    void resetCtrl()
+    {
+        memset(ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+    }
+
+    // Writes slot i's control byte and every mirrored copy of it
+    void setCtrl(int i, signed char c)
+    {
+        ctrl[i] = c;
+        for (int j = i + capacity; j < capacity + GROUP_WIDTH; j += capacity)
+            ctrl[j] = c;
+    }
+
+    // Slots of group g that haven't been covered by an earlier group
+    unsigned groupLimit(int g)
+    {
+        int remaining = capacity - g * GROUP_WIDTH;
+        return remaining >= GROUP_WIDTH ? 0xFFFFu : (1u << remaining) - 1;
+    }
+
+    // Appends 'value' to the end of bucket b's chain in table t
+    void appendToChain(SlotArray *t, int b, int value)
+    {
+        t->touch(b);
+        int &head = t->chainHead(b);
+        if (head == -1)
+        {
+            head = nodes.alloc(value, -1);
+            return;
+        }
+        int curr = head;
+        while (nodes[curr].next != -1)
+            curr = nodes[curr].next;
+        nodes[curr].next = nodes.alloc(value, -1);
+    }
+
+    // Removes the bucket value of b, promoting the first chain node into the bucket
+    void removeChainHead(SlotArray *t, int b)
+    {
+        int first = t->chainOf(b);
+        if (first == -1)
+        {
+            t->markEmpty(b);
+            return;
+        }
+        t->touch(b);
+        t->values[b] = nodes[first].value;
+        t->chainHead(b) = nodes[first].next;
+        nodes.release(first);
+    }
+
+    // Silent insert into the current table (value known to be absent). Returns the bucket.
+    int place(int value)
+    {
+        int initialIndex = hashIndex(value, capacity);
+
+        if (activeProbeType == 4 || activeProbeType == 5)
+        {
+            // Migration work is neither logged nor counted as probes of the operation
+            bool tracing = traceEnabled;
+            int probes = probeCount;
+            unsigned seen = outcome;
+            int live = size; // The value is already counted while it sits in the old table
+            traceEnabled = false;
+            int idx = activeProbeType == 4 ? robinHoodInsert(value) : groupInsert(value);
+            traceEnabled = tracing;
+            probeCount = probes;
+            outcome = seen;
+            size = live;
+            return idx;
+        }
+
+        if (activeProbeType == 3)
+        {
+            if (!table->occupied(initialIndex))
+                table->fill(initialIndex, value);
+            else
+                appendToChain(table, initialIndex, value);
+            return initialIndex;
+        }
+
+        for (int i = 0; i < capacity; i++)
+        {
+            int idx = probeIndex(initialIndex, i, activeProbeType, capacity);
+            if (!table->occupied(idx))
+            {
+                if (table->deleted(idx))
+                    tombstones--;
+                table->fill(idx, value);
+                return idx;
+            }
+        }
+        // Quadratic probing can miss free slots; never drop a value while rehashing
+        for (int idx = 0; idx < capacity; idx++)
+        {
+            if (!table->occupied(idx))
+            {
+                if (table->deleted(idx))
+                    tombstones--;
+                table->fill(idx, value);
+                return idx;
+            }
+        }
+        return -1;
+    }
+
+    // Moves one old bucket (and its chain) into the current table
+    void migrateBucket(int b)
+    {
+        if (!oldTable->occupied(b))
+            return;
+        int curr = oldTable->chainOf(b);
+        logStep(place(oldTable->values[b]), STEP_REHASHED, oldTable->values[b]);
+        while (curr != -1)
+        {
+            int next = nodes[curr].next;
+            int value = nodes[curr].value;
+            nodes.release(curr);
+            logStep(place(value), STEP_REHASHED, value);
+            curr = next;
+        }
+        // The slot keeps its (now stale) value so old probe sequences through it
+        // stay as short as they were; takeFromOld ignores hits below migrateCursor
+        if (oldTable->chainHeads)
+            oldTable->chainHeads[b] = -1;
+    }
+
+    void finishMigration()
+    {
+        delete oldTable;
+        oldTable = nullptr;
+        migrateCursor = 0;
+    }
+
+    // Amortized part of the rehash: a few old buckets per operation
+    void rehashStep()
+    {
+        if (!oldTable)
+            return;
+        for (int k = 0; k < REHASH_BATCH && migrateCursor < oldTable->capacity; k++)
+            migrateBucket(migrateCursor++);
+        if (migrateCursor >= oldTable->capacity)
+            finishMigration();
+    }
+
+    void drainAll()
+    {
+        while (oldTable)
+            rehashStep();
+    }
+
+    // setMaxLoadFactor(<= 0) turns growth off, so a full table stays full
+    bool growthEnabled() const
+    {
+        return maxLoadFactor < 1e9;
+    }
+
+    void maybeStartResize()
+    {
+        if ((double)(size + tombstones) <= maxLoadFactor * capacity)
+            return;
+
+        // Finish any rehash still in flight before starting another one
+        drainAll();
+
+        // Mostly tombstones: rebuild at the same size. Otherwise double.
+        int target = (double)size * 2 <= maxLoadFactor * capacity ? capacity : 2 * capacity;
+        startResize(tableSizeFor(target > 2 ? target : 2));
+    }
+
+    // An open-addressing insert ran out of probe slots below the load threshold
+    // (clustered keys, or quadratic probing missing free slots). Grows at once and
+    // moves everything over, so the caller can retry against the bigger table.
+    bool growForRetry()
+    {
+        if (!growthEnabled())
+            return false;
+        drainAll();
+        startResize(tableSizeFor(2 * capacity));
+        drainAll();
+        return true;
+    }
+
+    void startResize(int newCapacity)
+    {
+        oldTable = table;
+        migrateCursor = 0;
+
+        table = new SlotArray(newCapacity);
+        capacity = newCapacity;
+        fullRefresh = true;
+        tombstones = 0;
+        // The old table is drained with plain linear lookups, so its tags can go
+        delete[] ctrl;
+        ctrl = new signed char[capacity + GROUP_WIDTH];
+        STAT_ALLOC(capacity + GROUP_WIDTH);
+        resetCtrl();
+        logStep(-1, STEP_RESIZE, newCapacity);
+    }
+
+    // Finds 'value' in the old table. On a hit it is unlinked/tombstoned there and
+    // (unless remove is set) placed into the current table; returns the new bucket
+    // or -2 for a removal. Returns -1 if absent.
+    int takeFromOld(int value, bool remove)
+    {
+        if (!oldTable)
+            return -1;
+
+        int oldCapacity = oldTable->capacity;
+        int initialIndex = hashIndex(value, oldCapacity);
+        bool found = false;
+
+        if (activeProbeType == 3)
+        {
+            if (initialIndex < migrateCursor || !oldTable->occupied(initialIndex))
+                return -1;
+            if (oldTable->values[initialIndex] == value)
+            {
+                removeChainHead(oldTable, initialIndex);
+                found = true;
+            }
+            else
+            {
+                int *link = &oldTable->chainHead(initialIndex);
+                while (*link != -1 && nodes[*link].value != value)
+                    link = &nodes[*link].next;
+                if (*link != -1)
+                {
+                    int n = *link;
+                    *link = nodes[n].next;
+                    nodes.release(n);
+                    found = true;
+                }
+            }
+        }
+        else
+        {
+            // Robin Hood and group probing both place values along the linear sequence
+            int oldProbe = activeProbeType == 2 ? 2 : 1;
+            for (int i = 0; i < oldCapacity; i++)
+            {
+                int idx = probeIndex(initialIndex, i, oldProbe, oldCapacity);
+                if (oldTable->empty(idx))
+                    break;
+                if (oldTable->occupied(idx) && oldTable->values[idx] == value)
+                {
+                    if (idx < migrateCursor)
+                        return -1; // Already moved to the current table
+                    oldTable->markDeleted(idx);
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if (!found)
+            return -1;
+        if (remove)
+        {
+            size--;
+            return -2;
+        }
+        return place(value);
+    }
+
+    // --- Robin Hood (probeType 4) ---
+
+    // Returns the slot where 'value' ended up (or already was), -1 if full
+    int robinHoodInsert(int value)
+    {
+        if (size >= capacity)
+        {
+            // No room to carry a displaced value to; only a duplicate can succeed
+            int at = robinHoodFind(value);
+            if (at != -1)
+            {
+                logStep(at, STEP_DUPLICATE, value);
+                return at;
+            }
+            logStep(-1, STEP_FULL, value);
+            return -1;
+        }
+
+        int idx = hashIndex(value, capacity);
+        int carry = value; // Value looking for a slot; changes after a swap
+        int dist = 0;
+        int landed = -1;
+
+        for (int i = 0; i < capacity; i++)
+        {
+            if (!table->occupied(idx))
+            {
+                if (table->deleted(idx))
+                    tombstones--;
+                table->fill(idx, carry);
+                size++;
+                logStep(idx, STEP_INSERTED, carry);
+                return landed == -1 ? idx : landed;
+            }
+
+            int resident = table->values[idx];
+            if (landed == -1 && resident == value)
+            {
+                logStep(idx, STEP_DUPLICATE, value);
+                return idx;
+            }
+
+            int residentDist = probeDistance(resident, idx);
+            if (residentDist < dist)
+            {
+                // Take from the rich: the resident is closer to home than we are
+                table->touch(idx);
+                table->values[idx] = carry;
+                logStep(idx, STEP_SWAPPED, carry);
+                if (landed == -1)
+                    landed = idx;
+                carry = resident;
+                dist = residentDist;
+            }
+            else
+            {
+                logStep(idx, STEP_COLLISION, resident);
+            }
+
+            idx = (idx + 1) % capacity;
+            dist++;
+        }
+
+        logStep(-1, STEP_FULL, carry);
+        return -1;
+    }
+
+    // Returns the slot holding 'value' or -1. Stops as soon as a resident is
+    // closer to home than the probe distance so far.
+    int robinHoodFind(int value)
+    {
+        int idx = hashIndex(value, capacity);
+        for (int dist = 0; dist < capacity; dist++)
+        {
+            if (!table->occupied(idx))
+            {
+                logStep(idx, STEP_EMPTY, -1);
+                return -1;
+            }
+            int resident = table->values[idx];
+            if (resident == value)
+            {
+                logStep(idx, STEP_FOUND, value);
+                return idx;
+            }
+            if (probeDistance(resident, idx) < dist)
+            {
+                logStep(idx, STEP_NOT_FOUND, -1);
+                return -1;
+            }
+            logStep(idx, STEP_COLLISION, resident);
+            idx = (idx + 1) % capacity;
+        }
+        return -1;
+    }
+
+    // Backward-shift delete: pull the rest of the run one slot closer to home
+    void robinHoodRemove(int value)
+    {
+        int hole = robinHoodFind(value);
+        if (hole == -1)
+            return;
+        if (traceEnabled)
+            trace.back().status = STEP_REMOVED;
+        size--;
+
+        int next = (hole + 1) % capacity;
+        while (table->occupied(next) && probeDistance(table->values[next], next) > 0)
+        {
+            table->touch(hole);
+            table->values[hole] = table->values[next];
+            logStep(hole, STEP_SHIFTED, table->values[hole]);
+            hole = next;
+            next = (next + 1) % capacity;
+        }
+        table->markEmpty(hole);
+    }
+
+    // --- Group probing (probeType 5) ---
+
+    // Scans groups from H1(value) for a tag match. Returns the slot holding 'value' or
+    // -1; *freeSlot receives the first empty or deleted slot seen (-1 if none).
+    int groupFind(int value, int *freeSlot)
+    {
+        int home = hashIndex(value, capacity);
+        signed char tag = tagOf(value);
+        int groups = (capacity + GROUP_WIDTH - 1) / GROUP_WIDTH;
+        *freeSlot = -1;
+
+        for (int g = 0; g < groups; g++)
+        {
+            int pos = (home + g * GROUP_WIDTH) % capacity;
+            const signed char *group = ctrl + pos;
+            unsigned limit = groupLimit(g);
+            unsigned matches = matchGroup(group, tag) & limit;
+            unsigned empties = matchGroup(group, CTRL_EMPTY) & limit;
+
+            int matchCount = 0;
+            for (unsigned m = matches; m; m &= m - 1)
+                matchCount++;
+            logStep(pos, STEP_GROUP, matchCount);
+
+            for (unsigned m = matches; m; m &= m - 1)
+            {
+                int idx = (pos + lowestBit(m)) % capacity;
+                if (table->values[idx] == value)
+                    return idx;
+                logStep(idx, STEP_COLLISION, table->values[idx]); // Tag matched, value didn't
+            }
+
+            unsigned available = empties | (matchGroup(group, CTRL_DELETED) & limit);
+            if (*freeSlot == -1 && available)
+                *freeSlot = (pos + lowestBit(available)) % capacity;
+
+            // An empty byte ends every probe sequence that could contain 'value'
+            if (empties)
+                return -1;
+        }
+        return -1;
+    }
+
+    int groupInsert(int value)
+    {
+        int freeSlot;
+        int idx = groupFind(value, &freeSlot);
+        if (idx != -1)
+        {
+            logStep(idx, STEP_DUPLICATE, value);
+            return idx;
+        }
+        if (freeSlot == -1)
+        {
+            logStep(-1, STEP_FULL, value);
+            return -1;
+        }
+
+        if (table->deleted(freeSlot))
+            tombstones--;
+        table->fill(freeSlot, value);
+        setCtrl(freeSlot, tagOf(value));
+        size++;
+        logStep(freeSlot, STEP_INSERTED, value);
+        return freeSlot;
+    }
+
+    void groupSearch(int value)
+    {
+        int freeSlot;
+        int idx = groupFind(value, &freeSlot);
+        if (idx != -1)
+            logStep(idx, STEP_FOUND, value);
+        else
+            logStep(hashIndex(value, capacity), STEP_NOT_FOUND, -1);
+    }
+
+    void groupRemove(int value)
+    {
+        int freeSlot;
+        int idx = groupFind(value, &freeSlot);
+        if (idx == -1)
+        {
+            logStep(hashIndex(value, capacity), STEP_NOT_FOUND, -1);
+            return;
+        }
+        table->markDeleted(idx);
+        setCtrl(idx, CTRL_DELETED);
+        size--;
+        tombstones++;
+        logStep(idx, STEP_REMOVED, value);
+    }
+
+    // One open-addressing insert attempt (probeType 1, 2, 4 or 5). Returns false,
+    // having logged STEP_FULL, when the probe sequence had no room for the value.
+    bool openInsert(int value, int probeType)
+    {
+        if (probeType == 4)
+            return robinHoodInsert(value) != -1;
+        if (probeType == 5)
+            return groupInsert(value) != -1;
+
+        int initialIndex = hashIndex(value, capacity);
+        bool inserted = false;
+        int firstTombstone = -1;
+        for (int i = 0; i < capacity; i++)
+        {
+            int currentIndex = probeIndex(initialIndex, i, probeType, capacity);
+
+            // 1. Check for Duplicate
+            if (table->occupied(currentIndex) && table->values[currentIndex] == value)
+            {
+                logStep(currentIndex, STEP_DUPLICATE, value);
+                inserted = true;
+                break;
+            }
+
+            // 2. Check if Empty (Insertion Point, or the first tombstone we passed)
+            if (table->empty(currentIndex))
+            {
+                int target = firstTombstone != -1 ? firstTombstone : currentIndex;
+                if (table->deleted(target))
+                    tombstones--;
+                table->fill(target, value);
+                size++;
+
+                logStep(target, STEP_INSERTED, value);
+                inserted = true;
+                break;
+            }
+
+            // 3. Tombstone: reusable, but the value may still sit further along
+            if (table->deleted(currentIndex))
+            {
+                if (firstTombstone == -1)
+                    firstTombstone = currentIndex;
+                logStep(currentIndex, STEP_TOMBSTONE, -1);
+                continue;
+            }
+
+            // 4. Collision
+            logStep(currentIndex, STEP_COLLISION, table->values[currentIndex]);
+        }
+
+        if (!inserted && firstTombstone != -1)
+        {
+            // Whole probe sequence scanned without an empty slot: reuse the tombstone
+            tombstones--;
+            table->fill(firstTombstone, value);
+            size++;
+            logStep(firstTombstone, STEP_INSERTED, value);
+            inserted = true;
+        }
+
+        if (!inserted)
+        {
+            logStep(-1, STEP_FULL, value);
+        }
+        return inserted;
+    }
+
+public:
+    HashTable(int cap, int hashFn = HASH_MODULO)
+    {
+        hashType = (hashFn >= 0 && hashFn < HASH_TYPE_COUNT) ? hashFn : HASH_MODULO;
+        // Primes for modulo-style hashing, powers of two for Fibonacci
+        capacity = tableSizeFor(cap > 2 ? cap : 2);
+
+        // Fixed seed keeps tabulation runs reproducible
+        unsigned seed = 0x9E3779B9u;
+        for (int t = 0; t < 4; t++)
+        {
+            for (int b = 0; b < 256; b++)
+            {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                tabulation[t][b] = seed;
+            }
+        }
+
+        size = 0;
+        tombstones = 0;
+        table = new SlotArray(capacity);
+        oldTable = nullptr;
+        migrateCursor = 0;
+        maxLoadFactor = 0.7;
+        activeProbeType = 1;
+        traceEnabled = true;
+        probeCount = 0;
+        outcome = 0;
+        generation = 0;
+        fullRefresh = true;
+        ctrl = new signed char[capacity + GROUP_WIDTH];
+        STAT_ALLOC(capacity + GROUP_WIDTH);
+        resetCtrl();
+    }
+
+    ~HashTable()
+    {
+        delete table;
+        delete oldTable;
+        delete[] ctrl;
+    }
+
+    // Load factor above which the table grows (values <= 0 disable growth)
+    void setMaxLoadFactor(double lf)
+    {
+        maxLoadFactor = lf > 0 ? lf : 1e9;
+    }
+
+    int getCapacity() { return capacity; }
+
+    int getSize() { return size; }
+
+    // Turns step logging off for bulk work; probe counts are still kept
+    void setTraceEnabled(bool enabled) { traceEnabled = enabled; }
+
+    // Probe steps taken by the last insert/search/remove
+    int lastProbeCount() { return probeCount; }
+
+    // True if the last insert ran out of probe slots (even if it then grew and retried)
+    bool lastInsertExhausted() { return (outcome & (1u << STEP_FULL)) != 0; }
+
+    // Inserts (or looks up) n keys with step logging off and aggregates the probe
+    // lengths instead. Much cheaper than n traced calls for loading large datasets.
+    void runBatch(const int *keys, int n, int probeType, bool insert, BatchStats &stats)
+    {
+        memset(&stats, 0, sizeof(stats));
+        bool tracing = traceEnabled;
+        traceEnabled = false;
+        long long totalProbes = 0;
+
+        for (int i = 0; i < n; i++)
+        {
+            if (insert)
+                insertTraced(keys[i], probeType);
+            else
+                searchTraced(keys[i], probeType);
+
+            // A "full" step followed by a grow-and-retry still counts as stored
+            const unsigned stored = (1u << STEP_INSERTED) | (1u << STEP_INSERTED_CHAIN) | (1u << STEP_DUPLICATE);
+            bool failed = insert ? (outcome & stored) == 0
+                                 : (outcome & (1u << STEP_FOUND)) == 0;
+            if (failed)
+                stats.failures++;
+
+            totalProbes += probeCount;
+            if (probeCount > stats.maxProbe)
+                stats.maxProbe = probeCount;
+            int collisions = probeCount > 0 ? probeCount - 1 : 0;
+            stats.histogram[collisions < BATCH_HISTOGRAM_BINS ? collisions : BATCH_HISTOGRAM_BINS - 1]++;
+        }
+
+        trace.clear();
+        traceEnabled = tracing;
+        stats.ops = n;
+        stats.totalProbesLow = (int)(totalProbes & 0xFFFFFFFFLL);
+        stats.totalProbesHigh = (int)(totalProbes >> 32);
+    }
+
+    // Helper to format a step for the frontend animation log
+    // Format: {"index":4,"status":"collision","val":12}
+    static void formatStep(JsonWriter &ss, const TraceStep &step)
+    {
+        ss << "{\"index\":" << step.index << ",\"status\":\"" << STEP_NAMES[step.status] << "\",\"val\":" << step.value << "}";
+    }
+
+    // Serializes the current trace as the JSON log the visualizer animates
+    string traceToJSON()
+    {
+        JsonWriter logStream;
+        logStream << "[";
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            if (i > 0)
+                logStream << ",";
+            formatStep(logStream, trace[i]);
+        }
+        logStream << "]";
+        return logStream.str();
+    }
+
+    // Records the steps taken during insertion into the trace; returns the step count
+    // probeType: 1 = Linear, 2 = Quadratic, 3 = Chaining, 4 = Robin Hood, 5 = Group probing
+    int insertTraced(int value, int probeType)
+    {
+        trace.clear();
+        probeCount = 0;
+        outcome = 0;
+        if (size == 0 && !oldTable)
+            activeProbeType = probeType;
+        rehashStep();
+
+        // A value still waiting in the old table is a duplicate; move it over now
+        int moved = takeFromOld(value, false);
+        if (moved >= 0)
+        {
+            logStep(moved, STEP_REHASHED, value);
+            logStep(moved, STEP_DUPLICATE, value);
+            return (int)trace.size();
+        }
+
+        if (probeType != 3)
+        {
+            // Out of probe slots: grow instead of dropping the value, then retry
+            while (!openInsert(value, probeType) && growForRetry())
+            {
+            }
+            maybeStartResize();
+            return (int)trace.size();
+        }
+
+        int initialIndex = hashIndex(value, capacity);
+
+        // --- Separate Chaining Logic ---
+        // 1. Check Head
+        if (!table->occupied(initialIndex))
+        {
+            table->fill(initialIndex, value);
+            size++;
+            logStep(initialIndex, STEP_INSERTED, value);
+        }
+        else
+        {
+            // Collision at head, traverse chain
+            logStep(initialIndex, STEP_COLLISION, table->values[initialIndex]);
+
+            // Check head duplicate
+            bool duplicate = table->values[initialIndex] == value;
+
+            // Traverse list
+            int curr = table->chainOf(initialIndex);
+            while (curr != -1 && !duplicate)
+            {
+                logStep(initialIndex, STEP_TRAVERSING, nodes[curr].value); // Index remains bucket index for visuals
+                if (nodes[curr].value == value)
+                    duplicate = true;
+                curr = nodes[curr].next;
+            }
+
+            if (duplicate)
+            {
+                logStep(initialIndex, STEP_DUPLICATE, value);
+            }
+            else
+            {
+                // Append new node
+                appendToChain(table, initialIndex, value);
+                size++;
+                logStep(initialIndex, STEP_INSERTED_CHAIN, value);
+            }
+        }
+        maybeStartResize();
+        return (int)trace.size();
+    }
+
+    // Records the search path into the trace; returns the step count
+    int searchTraced(int value, int probeType)
+    {
+        trace.clear();
+        probeCount = 0;
+        outcome = 0;
+        rehashStep();
+
+        int moved = takeFromOld(value, false);
+        if (moved >= 0)
+        {
+            logStep(moved, STEP_REHASHED, value);
+            logStep(moved, STEP_FOUND, value);
+            return (int)trace.size();
+        }
+
+        if (probeType == 4)
+        {
+            robinHoodFind(value);
+            return (int)trace.size();
+        }
+        if (probeType == 5)
+        {
+            groupSearch(value);
+            return (int)trace.size();
+        }
+
+        int initialIndex = hashIndex(value, capacity);
+        bool found = false;
+
+        // --- Separate Chaining Search ---
+        if (probeType == 3)
+        {
+            if (!table->occupied(initialIndex))
+            {
+                logStep(initialIndex, STEP_EMPTY, -1);
+            }
+            else if (table->values[initialIndex] == value)
+            {
+                logStep(initialIndex, STEP_FOUND, value);
+            }
+            else
+            {
+                logStep(initialIndex, STEP_TRAVERSING, table->values[initialIndex]);
+                int curr = table->chainOf(initialIndex);
+                while (curr != -1)
+                {
+                    if (nodes[curr].value == value)
+                    {
+                        logStep(initialIndex, STEP_FOUND, value);
+                        found = true;
+                        break;
+                    }
+                    logStep(initialIndex, STEP_TRAVERSING, nodes[curr].value);
+                    curr = nodes[curr].next;
+                }
+                if (!found)
+                    logStep(initialIndex, STEP_NOT_FOUND, -1);
+            }
+            return (int)trace.size();
+        }
+
+        // --- Open Addressing Search ---
+        for (int i = 0; i < capacity; i++)
+        {
+            int currentIndex = probeIndex(initialIndex, i, probeType, capacity);
+
+            // If we hit an empty spot, item doesn't exist
+            if (table->empty(currentIndex))
+            {
+                logStep(currentIndex, STEP_EMPTY, -1);
+                break;
+            }
+
+            // Tombstones don't end the search
+            if (table->deleted(currentIndex))
+            {
+                logStep(currentIndex, STEP_TOMBSTONE, -1);
+                continue;
+            }
+
+            if (table->values[currentIndex] == value)
+            {
+                logStep(currentIndex, STEP_FOUND, value);
+                found = true;
+                break;
+            }
+
+            logStep(currentIndex, STEP_COLLISION, table->values[currentIndex]);
+        }
+
+        return (int)trace.size();
+    }
+
+    // Deletes 'value'. Open addressing leaves a tombstone so later probe chains
+    // stay intact; chaining unlinks the node. Returns the step count.
+    int removeTraced(int value, int probeType)
+    {
+        trace.clear();
+        probeCount = 0;
+        outcome = 0;
+        rehashStep();
+
+        if (takeFromOld(value, true) == -2)
+        {
+            logStep(-1, STEP_REMOVED, value);
+            return (int)trace.size();
+        }
+
+        if (probeType == 4 || probeType == 5)
+        {
+            if (probeType == 4)
+                robinHoodRemove(value);
+            else
+                groupRemove(value);
+            return (int)trace.size();
+        }
+
+        int initialIndex = hashIndex(value, capacity);
+
+        // --- Separate Chaining Delete ---
+        if (probeType == 3)
+        {
+            if (!table->occupied(initialIndex))
+            {
+                logStep(initialIndex, STEP_EMPTY, -1);
+                return (int)trace.size();
+            }
+            if (table->values[initialIndex] == value)
+            {
+                // Promote the first chain node into the bucket itself
+                removeChainHead(table, initialIndex);
+                size--;
+                logStep(initialIndex, STEP_REMOVED, value);
+                return (int)trace.size();
+            }
+
+            logStep(initialIndex, STEP_TRAVERSING, table->values[initialIndex]);
+            int *link = &table->chainHead(initialIndex);
+            while (*link != -1)
+            {
+                int n = *link;
+                if (nodes[n].value == value)
+                {
+                    table->touch(initialIndex);
+                    *link = nodes[n].next;
+                    nodes.release(n);
+                    size--;
+                    logStep(initialIndex, STEP_REMOVED, value);
+                    return (int)trace.size();
+                }
+                logStep(initialIndex, STEP_TRAVERSING, nodes[n].value);
+                link = &nodes[n].next;
+            }
+            logStep(initialIndex, STEP_NOT_FOUND, -1);
+            return (int)trace.size();
+        }
+
+        // --- Open Addressing Delete ---
+        for (int i = 0; i < capacity; i++)
+        {
+            int currentIndex = probeIndex(initialIndex, i, probeType, capacity);
+
+            if (table->empty(currentIndex))
+            {
+                logStep(currentIndex, STEP_EMPTY, -1);
+                break;
+            }
+            if (table->deleted(currentIndex))
+            {
+                logStep(currentIndex, STEP_TOMBSTONE, -1);
+                continue;
+            }
+            if (table->values[currentIndex] == value)
+            {
+                table->markDeleted(currentIndex);
+                size--;
+                tombstones++;
+                logStep(currentIndex, STEP_REMOVED, value);
+                break;
+            }
+            logStep(currentIndex, STEP_COLLISION, table->values[currentIndex]);
+        }
+
+        return (int)trace.size();
+    }
+
+    // Returns a JSON string describing the steps taken during insertion
+    string insert(int value, int probeType)
+    {
+        insertTraced(value, probeType);
+        return traceToJSON();
+    }
+
+    // Search function returning JSON log of search path
+    string search(int value, int probeType)
+    {
+        searchTraced(value, probeType);
+        return traceToJSON();
+    }
+
+    string remove(int value, int probeType)
+    {
+        removeTraced(value, probeType);
+        return traceToJSON();
+    }
+
+    // Binary view of the last trace: trace length TraceSteps starting here
+    TraceStep *traceData()
+    {
+        return trace.empty() ? nullptr : &trace[0];
+    }
+
+    // {"index":3,"occupied":true,"deleted":false,"value":42,"chain":[7,19]}
+    void writeSlotJSON(JsonWriter &ss, int i)
+    {
+        ss << "{";
+        ss << "\"index\":" << i << ",";
+        ss << "\"occupied\":" << (table->occupied(i) ? "true" : "false");
+        ss << ",\"deleted\":" << (table->deleted(i) ? "true" : "false");
+        if (table->occupied(i))
+        {
+            ss << ",\"value\":" << table->values[i];
+        }
+        else
+        {
+            ss << ",\"value\":null";
+        }
+
+        // Serialize Chain
+        ss << ",\"chain\":[";
+        int curr = table->chainOf(i);
+        while (curr != -1)
+        {
+            ss << nodes[curr].value;
+            curr = nodes[curr].next;
+            if (curr != -1)
+                ss << ",";
+        }
+        ss << "]";
+
+        ss << "}";
+    }
+
+    // Returns the full state of the table for rendering
+    string getTableJSON()
+    {
+        JsonWriter ss;
+        ss << "[";
+        for (int i = 0; i < capacity; i++)
+        {
+            writeSlotJSON(ss, i);
+            if (i < capacity - 1)
+                ss << ",";
+        }
+        ss << "]";
+        return ss.str();
+    }
+
+    // Slots changed since the previous call:
+    // {"generation":5,"capacity":13,"full":false,"slots":[<slot JSON>, ...]}
+    // After a resize or clear, "full" is true and every slot is listed.
+    // Unchanged tables return the same generation and an empty list.
+    string getTableDelta()
+    {
+        JsonWriter ss;
+        bool full = fullRefresh;
+        fullRefresh = false;
+
+        if (full)
+            table->clearDirty();
+        else
+            table->takeDirty(deltaSlots);
+
+        if (full || !deltaSlots.empty())
+            generation++;
+
+        ss << "{\"generation\":" << generation << ",\"capacity\":" << capacity
+           << ",\"full\":" << (full ? "true" : "false") << ",\"slots\":[";
+        int count = full ? capacity : (int)deltaSlots.size();
+        for (int k = 0; k < count; k++)
+        {
+            if (k > 0)
+                ss << ",";
+            writeSlotJSON(ss, full ? k : deltaSlots[k]);
+        }
+        ss << "]}";
+        if (!full)
+            deltaSlots.clear();
+        return ss.str();
+    }
+
+    void clear()
+    {
+        // O(capacity / 32): bitmaps are zeroed, every chain node is dropped at once
+        table->reset();
+        fullRefresh = true;
+        nodes.reset();
+        if (oldTable)
+            finishMigration();
+        resetCtrl();
+        size = 0;
+        tombstones = 0;
+    }
+};
+
+#endif
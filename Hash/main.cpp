@@ -1,7 +1,5 @@
-#include <iostream>
 #include <string>
-#include <sstream>
-#include <vector>
+#include <chrono>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -9,353 +7,283 @@
 #define EMSCRIPTEN_KEEPALIVE
 #endif
 
-using namespace std;
+#include "HashTable.h"
+#include "../Common/ResultRing.h"
+#include "../Common/Exports.h"
 
-// Represents a single slot in the Hash Table
-struct Entry
+// Key sets for the benchmark: the sequential and strided ones are where plain
+// modulo hashing clusters
+static int benchmarkKey(int i, int pattern)
 {
-    int value;
-    bool occupied; // false = empty, true = occupied
-    Entry *next;   // For Separate Chaining
-
-    Entry()
-    {
-        value = -1;
-        occupied = false;
-        next = nullptr;
-    }
-};
-
-class HashTable
-{
-private:
-    Entry *table;
-    int capacity;
-    int size;
-
-public:
-    HashTable(int cap)
+    switch (pattern)
     {
-        capacity = cap;
-        size = 0;
-        table = new Entry[capacity];
+    case 1:
+        return i * 64; // Strided
+    case 2:
+        return (int)fmix32((unsigned)i * 2654435761u + 1); // Pseudo-random
+    default:
+        return i; // Sequential
     }
+}
 
-    ~HashTable()
-    {
-        clear();
-        delete[] table;
-    }
+// Names of the HashType values, as the benchmark rows report them
+static const char *const HASH_NAMES[] = {"modulo", "fibonacci", "murmur3", "tabulation"};
 
-    // Helper to format a step for the frontend animation log
-    // Format: "index:status" (e.g., "4:collision")
-    string formatStep(int index, string status, int val)
-    {
-        stringstream ss;
-        ss << "{\"index\":" << index << ",\"status\":\"" << status << "\",\"val\":" << val << "}";
-        return ss.str();
-    }
-
-    // Returns a JSON string describing the steps taken during insertion
-    // probeType: 1 = Linear, 2 = Quadratic, 3 = Chaining
-    string insert(int value, int probeType)
+// Inserts n keys, then looks up n hits and n misses, with tracing off, for every
+// hash function x probe type. Returns one JSON row per combination:
+// {"hash":"murmur3","probeType":1,"avgProbe":1.42,"maxProbe":9,"nsPerOp":31.5,"capacity":32771,
+//  "exhausted":0,"failures":0}
+// "exhausted" counts inserts whose probe sequence found no free slot (the table then
+// grew and retried), "failures" keys that were still lost.
+static string runBenchmark(int n, int pattern)
+{
+    JsonWriter ss;
+    ss << "[";
+    bool firstRow = true;
+    for (int h = 0; h < HASH_TYPE_COUNT; h++)
     {
-        stringstream logStream;
-        logStream << "[";
-
-        int initialIndex = value % capacity;
-        bool inserted = false;
-
-        // --- Separate Chaining Logic ---
-        if (probeType == 3)
+        for (int probeType = 1; probeType <= 5; probeType++)
         {
-            // 1. Check Head
-            if (!table[initialIndex].occupied)
+            HashTable table(16, h);
+            table.setTraceEnabled(false);
+            long long totalProbes = 0;
+            int maxProbe = 0;
+            int failures = 0;
+            int exhausted = 0;
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (int i = 0; i < n; i++)
             {
-                table[initialIndex].value = value;
-                table[initialIndex].occupied = true;
-                table[initialIndex].next = nullptr;
-                size++;
-                logStream << formatStep(initialIndex, "inserted", value);
+                int before = table.getSize();
+                table.insertTraced(benchmarkKey(i, pattern), probeType);
+                if (table.getSize() == before)
+                    failures++; // Keys are distinct, so this insert hit "full"
+                if (table.lastInsertExhausted())
+                    exhausted++;
+                totalProbes += table.lastProbeCount();
+                if (table.lastProbeCount() > maxProbe)
+                    maxProbe = table.lastProbeCount();
             }
-            else
+            for (int i = 0; i < 2 * n; i++)
             {
-                // Collision at head, traverse chain
-                logStream << formatStep(initialIndex, "collision", table[initialIndex].value) << ",";
-
-                Entry *curr = &table[initialIndex];
-                bool duplicate = false;
-
-                // Check head duplicate
-                if (curr->value == value)
-                    duplicate = true;
-
-                // Traverse list
-                while (curr->next != nullptr && !duplicate)
-                {
-                    curr = curr->next;
-                    logStream << formatStep(initialIndex, "traversing", curr->value) << ","; // Index remains bucket index for visuals
-                    if (curr->value == value)
-                        duplicate = true;
-                }
-
-                if (duplicate)
-                {
-                    logStream << formatStep(initialIndex, "duplicate", value);
-                }
-                else
-                {
-                    // Append new node
-                    curr->next = new Entry();
-                    curr->next->value = value;
-                    curr->next->occupied = true;
-                    curr->next->next = nullptr;
-                    size++;
-                    logStream << formatStep(initialIndex, "inserted_chain", value);
-                }
+                // Odd rounds look up keys that were never inserted
+                int key = (i & 1) ? benchmarkKey(n + i, pattern) : benchmarkKey(i >> 1, pattern);
+                table.searchTraced(key, probeType);
+                totalProbes += table.lastProbeCount();
+                if (table.lastProbeCount() > maxProbe)
+                    maxProbe = table.lastProbeCount();
             }
-            logStream << "]";
-            return logStream.str();
-        }
-
-        // --- Open Addressing Logic (Linear/Quadratic) ---
-        for (int i = 0; i < capacity; i++)
-        {
-            int currentIndex;
-
-            if (probeType == 1)
-            {
-                // Linear Probing: (H(x) + i) % Size
-                currentIndex = (initialIndex + i) % capacity;
-            }
-            else
-            {
-                // Quadratic Probing: (H(x) + i*i) % Size
-                currentIndex = (initialIndex + (i * i)) % capacity;
-            }
-
-            if (i > 0)
-                logStream << ",";
-
-            // 1. Check for Duplicate
-            if (table[currentIndex].occupied && table[currentIndex].value == value)
-            {
-                logStream << formatStep(currentIndex, "duplicate", value);
-                inserted = true;
-                break;
-            }
-
-            // 2. Check if Empty (Insertion Point)
-            if (!table[currentIndex].occupied)
-            {
-                table[currentIndex].value = value;
-                table[currentIndex].occupied = true;
-                size++;
-
-                logStream << formatStep(currentIndex, "inserted", value);
-                inserted = true;
-                break;
-            }
-
-            // 3. Collision
-            logStream << formatStep(currentIndex, "collision", table[currentIndex].value);
-        }
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
 
-        if (!inserted)
-        {
-            logStream << ",{\"index\":-1,\"status\":\"full\",\"val\":" << value << "}";
+            int ops = 3 * n;
+            if (!firstRow)
+                ss << ",";
+            firstRow = false;
+            ss << "{\"hash\":\"" << HASH_NAMES[h] << "\",\"probeType\":" << probeType
+               << ",\"avgProbe\":" << (ops ? (double)totalProbes / ops : 0)
+               << ",\"maxProbe\":" << maxProbe
+               << ",\"nsPerOp\":" << (ops ? ns / ops : 0)
+               << ",\"capacity\":" << table.getCapacity()
+               << ",\"exhausted\":" << exhausted << ",\"failures\":" << failures << "}";
         }
-
-        logStream << "]";
-        return logStream.str();
     }
+    ss << "]";
+    return ss.str();
+}
 
-    // Search function returning JSON log of search path
-    string search(int value, int probeType)
-    {
-        stringstream logStream;
-        logStream << "[";
-
-        int initialIndex = value % capacity;
-        bool found = false;
-
-        // --- Separate Chaining Search ---
-        if (probeType == 3)
-        {
-            if (!table[initialIndex].occupied)
-            {
-                logStream << formatStep(initialIndex, "empty", -1);
-            }
-            else
-            {
-                Entry *curr = &table[initialIndex];
-                while (curr != nullptr)
-                {
-                    if (curr != &table[initialIndex])
-                        logStream << ",";
-
-                    if (curr->value == value)
-                    {
-                        logStream << formatStep(initialIndex, "found", value);
-                        found = true;
-                        break;
-                    }
-                    logStream << formatStep(initialIndex, "traversing", curr->value);
-                    curr = curr->next;
-                }
-                if (!found)
-                    logStream << "," << formatStep(initialIndex, "not_found", -1);
-            }
-            logStream << "]";
-            return logStream.str();
-        }
+// --- GLOBAL INTERFACE ---
+HashTable *globalTable = nullptr;
+BatchStats batchStats;
 
-        // --- Open Addressing Search ---
-        for (int i = 0; i < capacity; i++)
-        {
-            int currentIndex;
-            if (probeType == 1)
-                currentIndex = (initialIndex + i) % capacity;
-            else
-                currentIndex = (initialIndex + (i * i)) % capacity;
+extern "C"
+{
 
-            if (i > 0)
-                logStream << ",";
+    // hashType: 0=Modulo, 1=Fibonacci (capacity rounded up to a power of two),
+    // 2=Murmur3 finalizer, 3=Tabulation
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(initHashTable)(int capacity, int hashType)
+    {
+        if (globalTable)
+            delete globalTable;
+        globalTable = new HashTable(capacity, hashType);
+    }
 
-            // If we hit an empty spot, item doesn't exist
-            if (!table[currentIndex].occupied)
-            {
-                logStream << formatStep(currentIndex, "empty", -1);
-                break;
-            }
+    // JSON rows of avg/max probe length and ns/op for every hash x probe type.
+    // pattern: 0 = sequential keys, 1 = strided (x64), 2 = pseudo-random
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(runHashBenchmark)(int n, int pattern)
+    {
+        return resultRing.putString(runBenchmark(n, pattern));
+    }
 
-            if (table[currentIndex].occupied && table[currentIndex].value == value)
-            {
-                logStream << formatStep(currentIndex, "found", value);
-                found = true;
-                break;
-            }
+    // Returns a JSON Log of the steps taken: e.g. [{index:2, status:"collision"}, {index:3, status:"inserted"}]
+    // probeType: 1=Linear, 2=Quadratic, 3=Chaining
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(insertValue)(int val, int probeType)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalTable)
+            ENGINE_EXPORT(initHashTable)(12, HASH_MODULO); // Default size 12 if not init
+        return resultRing.putString(globalTable->insert(val, probeType));
+    }
 
-            logStream << formatStep(currentIndex, "collision", table[currentIndex].value);
-        }
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(removeValue)(int val, int probeType)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalTable)
+            return resultRing.putString("[]");
+        return resultRing.putString(globalTable->remove(val, probeType));
+    }
 
-        logStream << "]";
-        return logStream.str();
+    // Growth threshold for (live + deleted) / capacity; default 0.7
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(setMaxLoadFactor)(double lf)
+    {
+        if (globalTable)
+            globalTable->setMaxLoadFactor(lf);
     }
 
-    // Returns the full state of the table for rendering
-    string getTableJSON()
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(getCapacity)()
     {
-        stringstream ss;
-        ss << "[";
-        for (int i = 0; i < capacity; i++)
-        {
-            ss << "{";
-            ss << "\"index\":" << i << ",";
-            ss << "\"occupied\":" << (table[i].occupied ? "true" : "false");
-            if (table[i].occupied)
-            {
-                ss << ",\"value\":" << table[i].value;
-            }
-            else
-            {
-                ss << ",\"value\":null";
-            }
+        return globalTable ? globalTable->getCapacity() : 0;
+    }
 
-            // Serialize Chain
-            ss << ",\"chain\":[";
-            Entry *curr = table[i].next;
-            while (curr)
-            {
-                ss << curr->value;
-                curr = curr->next;
-                if (curr)
-                    ss << ",";
-            }
-            ss << "]";
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(searchValue)(int val, int probeType)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalTable)
+            return resultRing.putString("[]");
+        return resultRing.putString(globalTable->search(val, probeType));
+    }
 
-            ss << "}";
-            if (i < capacity - 1)
-                ss << ",";
-        }
-        ss << "]";
-        return ss.str();
+    // Returns the static view of the table including chains
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(getTableJSON)()
+    {
+        if (!globalTable)
+            return resultRing.putString("[]");
+        return resultRing.putString(globalTable->getTableJSON());
     }
 
-    void clear()
+    // Binary trace mode: same steps as insertValue/searchValue, but left in linear
+    // memory as packed {index, status, value} int32 triplets instead of JSON.
+    // Returns the number of steps; read them from getTraceBuffer().
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(insertValueTrace)(int val, int probeType)
     {
-        for (int i = 0; i < capacity; i++)
-        {
-            // Delete chain nodes
-            Entry *curr = table[i].next;
-            while (curr != nullptr)
-            {
-                Entry *temp = curr;
-                curr = curr->next;
-                delete temp;
-            }
-            table[i].next = nullptr;
-            table[i].occupied = false;
-            table[i].value = -1;
-        }
-        size = 0;
+        STAT_TIME_SCOPE();
+        if (!globalTable)
+            ENGINE_EXPORT(initHashTable)(12, HASH_MODULO);
+        return globalTable->insertTraced(val, probeType);
     }
-};
 
-// --- GLOBAL INTERFACE ---
-HashTable *globalTable = nullptr;
-std::string responseBuffer;
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(searchValueTrace)(int val, int probeType)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalTable)
+            return 0;
+        return globalTable->searchTraced(val, probeType);
+    }
 
-extern "C"
-{
+    EMSCRIPTEN_KEEPALIVE
+    int ENGINE_EXPORT(removeValueTrace)(int val, int probeType)
+    {
+        STAT_TIME_SCOPE();
+        if (!globalTable)
+            return 0;
+        return globalTable->removeTraced(val, probeType);
+    }
 
     EMSCRIPTEN_KEEPALIVE
-    void initHashTable(int capacity)
+    TraceStep *ENGINE_EXPORT(getTraceBuffer)()
     {
-        if (globalTable)
-            delete globalTable;
-        globalTable = new HashTable(capacity);
+        if (!globalTable)
+            return nullptr;
+        return globalTable->traceData();
     }
 
-    // Returns a JSON Log of the steps taken: e.g. [{index:2, status:"collision"}, {index:3, status:"inserted"}]
-    // probeType: 1=Linear, 2=Quadratic, 3=Chaining
+    // Bulk load: inserts n keys from linear memory without logging steps.
+    // Returns the number of failed inserts; details via getBatchStats().
     EMSCRIPTEN_KEEPALIVE
-    const char *insertValue(int val, int probeType)
+    int ENGINE_EXPORT(insertBatch)(const int *keys, int n, int probeType)
     {
+        STAT_TIME_SCOPE();
         if (!globalTable)
-            initHashTable(12); // Default size 12 if not init
-        responseBuffer = globalTable->insert(val, probeType);
-        return responseBuffer.c_str();
+            ENGINE_EXPORT(initHashTable)(12, HASH_MODULO);
+        globalTable->runBatch(keys, n, probeType, true, batchStats);
+        return batchStats.failures;
     }
 
+    // Returns the number of keys not found; details via getBatchStats()
     EMSCRIPTEN_KEEPALIVE
-    const char *searchValue(int val, int probeType)
+    int ENGINE_EXPORT(searchBatch)(const int *keys, int n, int probeType)
     {
+        STAT_TIME_SCOPE();
         if (!globalTable)
-            return "[]";
-        responseBuffer = globalTable->search(val, probeType);
-        return responseBuffer.c_str();
+            ENGINE_EXPORT(initHashTable)(12, HASH_MODULO);
+        globalTable->runBatch(keys, n, probeType, false, batchStats);
+        return batchStats.failures;
+    }
+
+    // BatchStats of the last insertBatch/searchBatch (5 + BATCH_HISTOGRAM_BINS int32s)
+    EMSCRIPTEN_KEEPALIVE
+    BatchStats *ENGINE_EXPORT(getBatchStats)()
+    {
+        return &batchStats;
     }
 
-    // Returns the static view of the table including chains
     EMSCRIPTEN_KEEPALIVE
-    const char *getTableJSON()
+    int ENGINE_EXPORT(getSize)()
+    {
+        return globalTable ? globalTable->getSize() : 0;
+    }
+
+    // Only the slots changed since the last call, plus a generation counter
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(getTableDelta)()
     {
         if (!globalTable)
-            return "[]";
-        responseBuffer = globalTable->getTableJSON();
-        return responseBuffer.c_str();
+            return resultRing.putString("{\"generation\":0,\"capacity\":0,\"full\":true,\"slots\":[]}");
+        return resultRing.putString(globalTable->getTableDelta());
     }
 
     EMSCRIPTEN_KEEPALIVE
-    void resetTable()
+    void ENGINE_EXPORT(resetTable)()
     {
         if (globalTable)
             globalTable->clear();
     }
+
+    // Instrumentation counters and export timings (see Common/Stats.h)
+    EMSCRIPTEN_KEEPALIVE
+    const char *ENGINE_EXPORT(getStats)()
+    {
+        return resultRing.putString(statsToJSON(STATS_MODULE));
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void ENGINE_EXPORT(resetStats)()
+    {
+        resetEngineStats(STATS_MODULE);
+    }
+
+    // Where the string exports' results live (Common/ResultRing.h); engine.js
+    // reads this once and decodes results straight out of the ring
+    EMSCRIPTEN_KEEPALIVE
+    const ResultRingInfo *ENGINE_EXPORT(getResultRing)()
+    {
+        return resultRing.getInfo();
+    }
 }
 
+// The combined build (Combined/combined.cpp) supplies its own main
+#ifndef COMBINED_BUILD
 int main()
 {
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,7 +1,8 @@
 /**
  * HASH TABLE VISUALIZER
  * Connects C++ WASM Logic to D3.js
- * Supports: Linear Probing, Quadratic Probing, Separate Chaining
+ * Supports: Linear Probing, Quadratic Probing, Separate Chaining, Robin Hood,
+ *           Group Probing (Swiss-table style control bytes)
  */
 
 // --- Configuration ---
@@ -12,6 +13,7 @@ const CONFIG = {
     bucketSpacing: 10,
     chainRadius: 20,
     chainSpacing: 40,
+    maxRenderBuckets: 400,  // Larger tables (bulk loads) only update the stats panel
     colors: {
         default: "#8b5cf6",    // Violet
         empty: "#ffffff",
@@ -23,14 +25,25 @@ const CONFIG = {
     }
 };
 
+// Step status codes from the C++ StepStatus enum (binary trace mode)
+const STEP_NAMES = ["inserted", "inserted_chain", "collision", "traversing", "duplicate",
+    "full", "empty", "found", "not_found", "tombstone", "removed", "resize", "rehashed",
+    "swapped", "shifted", "group"];
+const PROBE_MODE_NAMES = ["", "Linear Probing", "Quadratic Probing", "Separate Chaining",
+    "Robin Hood", "Group Probing"];
+const GROUP_WIDTH = 16; // Slots matched per probe in Group Probing mode
+
 // Global State
 let svg, g;
+let useBinaryTrace = true; // Read packed step structs from WASM memory instead of parsing JSON
 let isWasmReady = false;
-let currentProbeMode = 1; // 1=Linear, 2=Quadratic, 3=Chaining
+let currentProbeMode = 1; // 1=Linear, 2=Quadratic, 3=Chaining, 4=Robin Hood, 5=Group
 let currentCapacity = 12; // Must match C++ default
+let currentHashType = 0;  // 0=Modulo, 1=Fibonacci, 2=Murmur3, 3=Tabulation (C++ HashType)
 
 // Store D3 selections for easier animation access
 let bucketSelections = [];
+let renderedGeneration = -1; // Table generation currently drawn (from getTableDelta)
 
 // --- Initialization ---
 
@@ -39,25 +52,24 @@ window.onload = function () {
     setupEventListeners();
     setupDraggable();
 
-    // Check if Module loaded fast
-    if (typeof Module !== 'undefined' && Module.runtimeInitialized) {
+    // Check if the engine loaded fast (see ../engine.js)
+    if (Engine.isReady()) {
         onWasmReady();
     }
 };
 
-function onWasmReady() {
+async function onWasmReady() {
     isWasmReady = true;
-    Module.ccall('initHashTable', null, ['number'], [currentCapacity]);
     const status = document.getElementById('systemStatus');
     if (status) status.innerHTML = '<span class="status-dot ready"></span> System: Ready';
 
-    logConsole(">> WASM Core Loaded. Hash Table (Size 12) Ready.");
+    logConsole(`>> WASM Core Loaded (${Engine.mode} mode). Hash Table Ready.`);
 
     // Initialize Hash Table in C++
-    Module.ccall('initHashTable', null, ['number'], [TABLE_CAPACITY]);
+    await Engine.call('initHashTable', null, ['number', 'number'], [currentCapacity, currentHashType]);
 
     // Initial Render
-    refreshTable();
+    await refreshTable();
 }
 
 function initD3() {
@@ -92,9 +104,14 @@ function initD3() {
 function setupEventListeners() {
     document.getElementById('insertBtn').onclick = handleInsert;
     document.getElementById('searchBtn').onclick = handleSearch;
+    document.getElementById('deleteBtn').onclick = handleDelete;
+    document.getElementById('bulkInsertBtn').onclick = handleBulkInsert;
+    document.getElementById('bulkSearchBtn').onclick = handleBulkSearch;
     document.getElementById('generateRandomBtn').onclick = handleRandom;
     document.getElementById('clearBtn').onclick = handleClear;
     document.getElementById('resizeBtn').onclick = handleResize;
+    document.getElementById('hashFunction').onchange = handleHashChange;
+    document.getElementById('benchmarkBtn').onclick = handleBenchmark;
 
     document.getElementById('btnClearConsole').onclick = () => {
         document.getElementById('outputConsole').innerHTML = '<div class="log-entry system">>> Console Cleared.</div>';
@@ -104,8 +121,7 @@ function setupEventListeners() {
     window.updateProbeMode = (mode) => {
         currentProbeMode = mode;
         handleClear(); // Reset table on mode switch to avoid inconsistent state
-        let modeName = mode === 1 ? "Linear Probing" : (mode === 2 ? "Quadratic Probing" : "Separate Chaining");
-        logConsole(`>> Switched to ${modeName}`);
+        logConsole(`>> Switched to ${PROBE_MODE_NAMES[mode]}`);
     };
 }
 
@@ -125,14 +141,13 @@ async function handleInsert() {
     toggleControls(false);
 
     // Call C++: Get Animation Log
-    const logStr = Module.ccall('insertValue', 'string', ['number', 'number'], [val, currentProbeMode]);
-    const steps = JSON.parse(logStr);
+    const steps = await runTraced('insertValue', val);
 
     // Animate
     await animateSequence(steps);
 
     // Refresh to ensure final consistency
-    refreshTable();
+    await refreshTable();
     toggleControls(true);
     input.value = '';
     input.focus();
@@ -148,8 +163,7 @@ async function handleSearch() {
     logConsole(`>> Searching for ${val}...`);
     toggleControls(false);
 
-    const logStr = Module.ccall('searchValue', 'string', ['number', 'number'], [val, currentProbeMode]);
-    const steps = JSON.parse(logStr);
+    const steps = await runTraced('searchValue', val);
 
     await animateSequence(steps);
 
@@ -161,26 +175,153 @@ async function handleSearch() {
     }, 1000);
 }
 
+async function handleDelete() {
+    if (!isWasmReady) return;
+    const input = document.getElementById('nodeValue');
+    const val = parseInt(input.value);
+
+    if (isNaN(val)) return;
+
+    logConsole(`>> Deleting ${val}...`);
+    toggleControls(false);
+
+    const steps = await runTraced('removeValue', val);
+
+    await animateSequence(steps);
+
+    await refreshTable();
+    toggleControls(true);
+}
+
+// Keys of the last bulk load, reused by Bulk Search
+let bulkKeys = null;
+
+// Loads N random keys through insertBatch: one call, no step log, stats only
+async function handleBulkInsert() {
+    if (!isWasmReady) return;
+    const n = parseInt(document.getElementById('bulkCount').value);
+    if (isNaN(n) || n < 1) return;
+
+    bulkKeys = new Int32Array(n);
+    for (let i = 0; i < n; i++) bulkKeys[i] = Math.floor(Math.random() * 1e9);
+
+    toggleControls(false);
+    logConsole(`>> Bulk inserting ${n} random keys...`);
+    const t0 = performance.now();
+    await Engine.call('insertBatch', 'number', ['int32array', 'number', 'number'], [bulkKeys.slice(), n, currentProbeMode]);
+    await logBatchStats("Insert", performance.now() - t0);
+    await refreshTable();
+    toggleControls(true);
+}
+
+async function handleBulkSearch() {
+    if (!isWasmReady || !bulkKeys) {
+        logConsole(">> Bulk Search looks up the keys of the last Bulk Insert.");
+        return;
+    }
+    toggleControls(false);
+    logConsole(`>> Bulk searching ${bulkKeys.length} keys...`);
+    const t0 = performance.now();
+    await Engine.call('searchBatch', 'number', ['int32array', 'number', 'number'], [bulkKeys.slice(), bulkKeys.length, currentProbeMode]);
+    await logBatchStats("Search", performance.now() - t0);
+    toggleControls(true);
+}
+
+// BatchStats layout: ops, failures, maxProbe, totalProbes (lo, hi), histogram[16]
+async function logBatchStats(label, ms) {
+    const raw = await Engine.readInt32('getBatchStats', 5 + 16);
+    const ops = raw[0];
+    const totalProbes = (raw[3] >>> 0) + raw[4] * 4294967296;
+    logConsole(`${label}: ${ops} ops in ${ms.toFixed(1)} ms, avg ${(totalProbes / Math.max(ops, 1)).toFixed(2)} / max ${raw[2]} probes, ${raw[1]} failed`);
+
+    const hist = [];
+    for (let k = 0; k < 16; k++) {
+        if (raw[5 + k]) hist.push(`${k}${k === 15 ? '+' : ''}:${raw[5 + k]}`);
+    }
+    logConsole(`Collisions per op -> ${hist.join('  ')}`);
+}
+
 function handleRandom() {
     const val = Math.floor(Math.random() * 900) + 100; // 3 digit numbers look nice
     document.getElementById('nodeValue').value = val;
     handleInsert();
 }
 
-function handleClear() {
+async function handleClear() {
     if (!isWasmReady) return;
-    Module.ccall('resetTable', null, [], []);
-    refreshTable();
+    await Engine.call('resetTable', null, [], []);
+    await refreshTable();
     logConsole(">> Table Reset.");
 }
 
+// Runs insertValue/searchValue and returns the step list. In binary trace mode the
+// C++ side leaves {index, status, value} int32 triplets in memory and we decode them
+// directly; if the loaded module predates that export we fall back to the JSON log.
+async function runTraced(fnName, val) {
+    if (useBinaryTrace) {
+        try {
+            const count = await Engine.call(fnName + 'Trace', 'number', ['number', 'number'], [val, currentProbeMode]);
+            const raw = await Engine.readInt32('getTraceBuffer', count * 3);
+            const steps = new Array(count);
+            for (let i = 0; i < count; i++) {
+                steps[i] = { index: raw[i * 3], status: STEP_NAMES[raw[i * 3 + 1]], val: raw[i * 3 + 2] };
+            }
+            return steps;
+        } catch (e) {
+            console.warn("Binary trace unavailable, using JSON log:", e);
+            useBinaryTrace = false;
+        }
+    }
+    const logStr = await Engine.call(fnName, 'string', ['number', 'number'], [val, currentProbeMode]);
+    return JSON.parse(logStr);
+}
+
 // --- Visualization & Animation ---
 
-function refreshTable() {
-    const jsonStr = Module.ccall('getTableJSON', 'string', [], []);
-    const data = JSON.parse(jsonStr);
-    renderTable(data);
-    updateStats(data);
+async function refreshTable() {
+    // The table grows by itself once the load factor passes the threshold
+    currentCapacity = await Engine.call('getCapacity', 'number', [], []);
+    const itemCount = await Engine.call('getSize', 'number', [], []);
+
+    // Only the slots that changed since the last refresh come back; "full" after a
+    // resize or reset. Consumed even when nothing is drawn so the dirty set drains.
+    const delta = JSON.parse(await Engine.call('getTableDelta', 'string', [], []));
+
+    if (currentCapacity > CONFIG.maxRenderBuckets) {
+        g.selectAll("*").remove();
+        g.append("text")
+            .attr("class", "index-label")
+            .attr("x", svg.node().clientWidth / 2)
+            .attr("y", 100)
+            .attr("text-anchor", "middle")
+            .text(`${itemCount} keys in ${currentCapacity} buckets (too large to draw)`);
+        updateStats(itemCount);
+        return;
+    }
+
+    if (delta.full || g.select(".bucket-group").empty()) {
+        if (delta.full) renderTable(delta.slots);
+        else renderTable(JSON.parse(await Engine.call('getTableJSON', 'string', [], [])));
+    } else if (delta.generation !== renderedGeneration) {
+        updateBuckets(delta.slots);
+    }
+    renderedGeneration = delta.generation;
+    updateStats(itemCount);
+}
+
+// Redraws just the given slots inside the existing bucket groups
+function updateBuckets(slots) {
+    slots.forEach(d => {
+        const group = d3.select(`#bucket-${d.index}`).datum(d);
+        group.select(".bucket-rect")
+            .attr("class", `bucket-rect ${d.occupied ? "occupied" : ""} ${d.deleted ? "deleted" : ""}`);
+        group.select(".bucket-text")
+            .attr("class", `bucket-text ${d.value === null ? "placeholder" : ""}`)
+            .text(d.value !== null ? d.value : "");
+
+        group.selectAll(".chain-link, .chain-node-group").remove();
+        if (currentProbeMode === 3) drawChain(group, d);
+    });
 }
 
 function renderTable(data) {
@@ -210,7 +351,7 @@ function renderTable(data) {
 
     // Bucket Rectangle
     buckets.append("rect")
-        .attr("class", d => `bucket-rect ${d.occupied === "true" ? "occupied" : ""}`)
+        .attr("class", d => `bucket-rect ${d.occupied ? "occupied" : ""} ${d.deleted ? "deleted" : ""}`)
         .attr("width", CONFIG.bucketWidth)
         .attr("height", CONFIG.bucketHeight)
         .attr("rx", 6)
@@ -227,52 +368,52 @@ function renderTable(data) {
 
     // 2. Draw Chains (If Separate Chaining Mode and chain exists)
     if (currentProbeMode === 3) {
-        data.forEach((d, i) => {
-            if (d.chain && d.chain.length > 0) {
-                const parentGroup = d3.select(`#bucket-${d.index}`);
-
-                // Draw connecting line from bucket to first node
-                parentGroup.append("line")
-                    .attr("class", "chain-link")
-                    .attr("x1", CONFIG.bucketWidth / 2)
-                    .attr("y1", CONFIG.bucketHeight)
-                    .attr("x2", CONFIG.bucketWidth / 2)
-                    .attr("y2", CONFIG.bucketHeight + CONFIG.chainSpacing);
-
-                // Draw Chain Nodes
-                d.chain.forEach((val, cIdx) => {
-                    const yPos = CONFIG.bucketHeight + CONFIG.chainSpacing + (cIdx * CONFIG.chainSpacing);
-
-                    const chainGroup = parentGroup.append("g")
-                        .attr("class", "chain-node-group")
-                        .attr("id", `chain-${d.index}-${cIdx}`) // ID for animation
-                        .attr("transform", `translate(${CONFIG.bucketWidth / 2}, ${yPos})`);
-
-                    // Link to next node (if exists)
-                    if (cIdx < d.chain.length - 1) {
-                        parentGroup.append("line")
-                            .attr("class", "chain-link")
-                            .attr("x1", CONFIG.bucketWidth / 2)
-                            .attr("y1", yPos + CONFIG.chainRadius) // bottom of current circle
-                            .attr("x2", CONFIG.bucketWidth / 2)
-                            .attr("y2", yPos + CONFIG.chainSpacing - CONFIG.chainRadius); // top of next
-                    }
-
-                    chainGroup.append("circle")
-                        .attr("class", "chain-node")
-                        .attr("r", CONFIG.chainRadius);
-
-                    chainGroup.append("text")
-                        .attr("class", "chain-text")
-                        .attr("dy", ".35em")
-                        .attr("text-anchor", "middle")
-                        .text(val);
-                });
-            }
-        });
+        data.forEach(d => drawChain(d3.select(`#bucket-${d.index}`), d));
     }
 }
 
+function drawChain(parentGroup, d) {
+    if (!d.chain || d.chain.length === 0) return;
+
+    // Draw connecting line from bucket to first node
+    parentGroup.append("line")
+        .attr("class", "chain-link")
+        .attr("x1", CONFIG.bucketWidth / 2)
+        .attr("y1", CONFIG.bucketHeight)
+        .attr("x2", CONFIG.bucketWidth / 2)
+        .attr("y2", CONFIG.bucketHeight + CONFIG.chainSpacing);
+
+    // Draw Chain Nodes
+    d.chain.forEach((val, cIdx) => {
+        const yPos = CONFIG.bucketHeight + CONFIG.chainSpacing + (cIdx * CONFIG.chainSpacing);
+
+        const chainGroup = parentGroup.append("g")
+            .attr("class", "chain-node-group")
+            .attr("id", `chain-${d.index}-${cIdx}`) // ID for animation
+            .attr("transform", `translate(${CONFIG.bucketWidth / 2}, ${yPos})`);
+
+        // Link to next node (if exists)
+        if (cIdx < d.chain.length - 1) {
+            parentGroup.append("line")
+                .attr("class", "chain-link")
+                .attr("x1", CONFIG.bucketWidth / 2)
+                .attr("y1", yPos + CONFIG.chainRadius) // bottom of current circle
+                .attr("x2", CONFIG.bucketWidth / 2)
+                .attr("y2", yPos + CONFIG.chainSpacing - CONFIG.chainRadius); // top of next
+        }
+
+        chainGroup.append("circle")
+            .attr("class", "chain-node")
+            .attr("r", CONFIG.chainRadius);
+
+        chainGroup.append("text")
+            .attr("class", "chain-text")
+            .attr("dy", ".35em")
+            .attr("text-anchor", "middle")
+            .text(val);
+    });
+}
+
 // --- Animation Engine ---
 
 async function animateSequence(steps) {
@@ -281,10 +422,33 @@ async function animateSequence(steps) {
     for (let i = 0; i < steps.length; i++) {
         const step = steps[i];
 
-        // Handle "Full" error case
+        // Handle "Full": a following 'resize' means the table grew and the insert is retried
+        const retried = step.status === 'full' && i + 1 < steps.length && steps[i + 1].status === 'resize';
+        if (step.status === 'full') {
+            if (retried) {
+                logConsole(`No free slot on the probe path for ${step.val}. Growing the table and retrying.`);
+            } else {
+                logConsole(`Error: Table is full. Cannot insert ${step.val}.`);
+                alert("Table is Full!");
+            }
+            continue;
+        }
+
+        // Load factor threshold crossed: redraw at the new capacity, values follow
+        // over the next few operations as 'rehashed' steps
+        if (step.status === 'resize') {
+            if (i > 0 && steps[i - 1].status === 'full') {
+                logConsole(`Grew table to ${step.val} buckets.`);
+            } else {
+                logConsole(`Load factor exceeded. Growing table to ${step.val} buckets (incremental rehash).`);
+            }
+            await refreshTable();
+            continue;
+        }
+
+        // Removed while still in the old table: nothing on screen to highlight
         if (step.index === -1) {
-            logConsole(`Error: Table is full. Cannot insert ${step.val}.`);
-            alert("Table is Full!");
+            if (step.status === 'removed') logConsole(`Removed ${step.val}.`);
             continue;
         }
 
@@ -295,6 +459,8 @@ async function animateSequence(steps) {
         if (step.status === 'collision') logConsole(`Collision at index ${step.index} (Value: ${step.val})`);
         else if (step.status === 'inserted') logConsole(`Inserted ${step.val} at index ${step.index}`);
         else if (step.status === 'traversing') logConsole(`Traversing chain at index ${step.index}...`);
+        else if (step.status === 'tombstone') logConsole(`Index ${step.index} is a tombstone, continuing...`);
+        else if (step.status === 'rehashed') logConsole(`Rehashed ${step.val} into index ${step.index}`);
 
         // --- Visual Effects based on Status ---
 
@@ -338,7 +504,47 @@ async function animateSequence(steps) {
             await wait(CONFIG.animSpeed);
         }
 
-        // 5. Empty / Not Found (Amber Fade)
+        // 5. Robin Hood swap / backward shift (value moves into this slot)
+        else if (step.status === 'swapped' || step.status === 'shifted') {
+            bucketSel.classed("highlight-scan", true);
+            textSel.text(step.val).classed("placeholder", false);
+            logConsole(step.status === 'swapped'
+                ? `Robin Hood: ${step.val} takes index ${step.index}, carrying the displaced value on`
+                : `Shifted ${step.val} back to index ${step.index}`);
+            await wait(400);
+            bucketSel.classed("highlight-scan", false);
+        }
+
+        // 6. Group probe (flash the 16 slots whose control bytes were compared at once)
+        else if (step.status === 'group') {
+            const width = Math.min(GROUP_WIDTH, currentCapacity);
+            const groupSel = d3.selectAll('.bucket-group')
+                .filter(d => (d.index - step.index + currentCapacity) % currentCapacity < width)
+                .select('.bucket-rect');
+            logConsole(`Probing group at index ${step.index} (${step.val} tag match${step.val === 1 ? '' : 'es'})`);
+            groupSel.classed("highlight-scan", true);
+            await wait(300);
+            groupSel.classed("highlight-scan", false);
+        }
+
+        // 7. Removed (Red, slot becomes a tombstone or chain shrinks)
+        else if (step.status === 'removed') {
+            bucketSel.classed("highlight-collision", true);
+            logConsole(`Removed ${step.val} from index ${step.index}`);
+            if (currentProbeMode !== 3) textSel.text("");
+            await wait(CONFIG.animSpeed);
+            bucketSel.classed("highlight-collision", false);
+        }
+
+        // 8. Tombstone / Rehashed (Amber flash)
+        else if (step.status === 'tombstone' || step.status === 'rehashed') {
+            bucketSel.classed("highlight-scan", true);
+            if (step.status === 'rehashed' && currentProbeMode !== 3) textSel.text(step.val).classed("placeholder", false);
+            await wait(300);
+            bucketSel.classed("highlight-scan", false);
+        }
+
+        // 9. Empty / Not Found (Amber Fade)
         else if (step.status === 'empty') {
             bucketSel.classed("highlight-scan", true);
             logConsole(`Index ${step.index} is empty.`);
@@ -352,18 +558,9 @@ async function animateSequence(steps) {
 
 // --- Helpers ---
 
-function updateStats(data) {
-    let occupied = 0;
-    // Count occupied buckets
-    data.forEach(d => {
-        if (d.occupied === "true") occupied++;
-        // If chaining, count chain items too? 
-        // Load Factor usually just (Items / Capacity). 
-        // If chaining, size includes chain nodes.
-        if (d.chain) occupied += d.chain.length;
-    });
-
-    const loadFactor = (occupied / currentCapacity).toFixed(2);
+function updateStats(itemCount) {
+    // Load Factor = Items / Capacity (chained items included)
+    const loadFactor = (itemCount / currentCapacity).toFixed(2);
     const capDisplay = document.getElementById('capacityDisplay'); // Ensure this ID exists in HTML
     if (capDisplay) capDisplay.innerText = currentCapacity;
     document.getElementById('loadFactor').innerText = loadFactor;
@@ -373,6 +570,7 @@ function updateStats(data) {
     if (loadFactor > 0.7) lfEl.style.color = CONFIG.colors.collision;
     else if (loadFactor > 0.5) lfEl.style.color = CONFIG.colors.scanning;
     else lfEl.style.color = CONFIG.colors.success;
+    Engine.renderStats(document.getElementById('engineStats'));
 }
 
 function logConsole(msg) {
@@ -423,7 +621,7 @@ function setupDraggable() {
         el.classList.remove('dragging');
     });
 }
-function handleResize() {
+async function handleResize() {
     if (!isWasmReady) return;
 
     const input = document.getElementById('tableCapacity');
@@ -442,8 +640,43 @@ function handleResize() {
     logConsole(`>> Resizing table to ${currentCapacity}...`);
 
     // Re-initialize C++ Backend with new size
-    Module.ccall('initHashTable', null, ['number'], [currentCapacity]);
+    await Engine.call('initHashTable', null, ['number', 'number'], [currentCapacity, currentHashType]);
 
     // Refresh Visualization
-    refreshTable();
-}
\ No newline at end of file
+    await refreshTable();
+}
+
+async function handleHashChange() {
+    if (!isWasmReady) return;
+    currentHashType = parseInt(document.getElementById('hashFunction').value);
+    const label = document.getElementById('hashFunction').selectedOptions[0].text;
+    logConsole(`>> Hash function: ${label}. Table re-initialized.`);
+
+    // The capacity is rounded up to a prime (a power of two for Fibonacci); refreshTable picks it up
+    await Engine.call('initHashTable', null, ['number', 'number'], [currentCapacity, currentHashType]);
+    await refreshTable();
+}
+
+// Runs every hash function x probe strategy on 20k keys in C++ and logs the results.
+// Runs in a fresh table, so the visualized one is untouched.
+async function handleBenchmark() {
+    if (!isWasmReady) return;
+    const KEYS = 20000;
+    const patterns = ["sequential", "strided", "random"];
+    toggleControls(false);
+    logConsole(`>> Benchmarking ${KEYS} inserts + ${2 * KEYS} lookups per combination...`);
+
+    for (let p = 0; p < patterns.length; p++) {
+        const rows = JSON.parse(await Engine.call('runHashBenchmark', 'string', ['number', 'number'], [KEYS, p]));
+        logConsole(`-- ${patterns[p]} keys --`);
+        rows.forEach(r => {
+            logConsole(`${r.hash.padEnd(10)} ${PROBE_MODE_NAMES[r.probeType].padEnd(18)} avg ${r.avgProbe.toFixed(2)} / max ${r.maxProbe} probes, ${r.nsPerOp.toFixed(1)} ns/op`);
+        });
+        // Probe exhaustion is reported on its own: those rows also paid for emergency growth
+        const troubled = rows.filter(r => r.exhausted || r.failures);
+        troubled.forEach(r => {
+            logConsole(`   ${r.hash} + ${PROBE_MODE_NAMES[r.probeType]}: ${r.exhausted} inserts ran out of probe slots, ${r.failures} keys lost`);
+        });
+    }
+    toggleControls(true);
+}
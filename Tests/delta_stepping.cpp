@@ -0,0 +1,87 @@
+// Native regression checks for ParallelGraph::DeltaStepping (the "Run Tests (native)"
+// task in .vscode/tasks.json). Every case is compared against DijkstraAlgorithm;
+// the program prints one line per failure and exits non-zero if any case failed.
+//
+//   delta_stepping
+
+#include <cstdio>
+#include <vector>
+
+#include "../Graph/Graph.h"
+#include "../Graph/ParallelGraph.h"
+
+using namespace std;
+
+static int failures = 0;
+
+static void expectSameAsDijkstra(Graph &graph, int start, int delta, int threads, const char *name)
+{
+    int n = graph.vertexCount();
+    vector<int> expected(n), actual(n);
+    graph.DijkstraAlgorithm(start, expected.data());
+    ParallelGraph(graph, threads).DeltaStepping(start, actual.data(), delta);
+    for (int v = 0; v < n; v++)
+    {
+        if (actual[v] != expected[v])
+        {
+            printf("FAIL %s: dist[%d] = %d, Dijkstra says %d\n", name, v, actual[v], expected[v]);
+            failures++;
+            return;
+        }
+    }
+}
+
+// One edge of weight 10^9 with delta = 1: buckets must stay bounded by the
+// weight range instead of reaching dist / delta entries
+static void testLargeWeightSmallDelta()
+{
+    Graph graph(2);
+    graph.addEdge(0, 1, 1000000000);
+    graph.finalize();
+    expectSameAsDijkstra(graph, 0, 1, 1, "large weight, delta 1");
+}
+
+// A chain of heavy edges followed by light ones, so buckets wrap around the
+// cyclic array many times
+static void testChainWrapsBuckets()
+{
+    const int n = 64;
+    Graph graph(n);
+    for (int v = 0; v + 1 < n; v++)
+        graph.addEdge(v, v + 1, v % 2 ? 1 : 5000000);
+    graph.finalize();
+    expectSameAsDijkstra(graph, 0, 1, 2, "heavy/light chain");
+}
+
+// Random sparse graphs over small and large weight ranges, 1..4 threads
+static void testRandomGraphs()
+{
+    unsigned state = 12345;
+    auto next = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+    for (int t = 0; t < 200; t++)
+    {
+        int n = 1 + (int)(next() % 200);
+        int maxWeight = t % 3 == 0 ? 1000000 : (t % 3 == 1 ? 100 : 5);
+        Graph graph(n);
+        int edges = (int)(next() % (unsigned)(4 * n + 1));
+        for (int i = 0; i < edges; i++)
+            graph.addEdge((int)(next() % n), (int)(next() % n), (int)(next() % maxWeight));
+        graph.finalize();
+        char name[64];
+        snprintf(name, sizeof(name), "random graph %d", t);
+        expectSameAsDijkstra(graph, 0, 1 + (int)(next() % 50), 1 + t % 4, name);
+    }
+}
+
+int main()
+{
+    testLargeWeightSmallDelta();
+    testChainWrapsBuckets();
+    testRandomGraphs();
+    if (failures == 0)
+        printf("delta_stepping: all cases passed\n");
+    return failures == 0 ? 0 : 1;
+}
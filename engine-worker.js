@@ -0,0 +1,124 @@
+/**
+ * DATA_STRUCTURES_VISUALIZER // WASM ENGINE WORKER
+ * Worker side of engine.js. Loads one Emscripten module with importScripts and
+ * services 'boot', 'call' and 'read' messages. Int32Array results are sent back
+ * as transferred ArrayBuffers, so nothing large is structured-cloned. String
+ * results are decoded straight out of the module's result ring, and the .wasm is
+ * stream-compiled through wasm-cache.js, the same as on the page.
+ */
+
+try {
+    importScripts('wasm-cache.js');
+} catch (e) {
+    // The glue script fetches and compiles the .wasm itself
+}
+
+let moduleReady = null;
+// Export prefix for the combined module (engine.js has already applied it to calls)
+let prefix = '';
+// HEAP32 index of the module's ResultRingInfo, 0 if it has none
+let ringInfo = -1;
+const decoder = new TextDecoder('utf-8');
+
+function bootModule(scripts, namePrefix) {
+    prefix = namePrefix || '';
+    moduleReady = new Promise((resolve, reject) => {
+        let loaded = null;
+        self.Module = {
+            // .wasm files sit next to their glue script, not next to this worker
+            locateFile: (path) => new URL(path, loaded).href,
+            onRuntimeInitialized: () => resolve()
+        };
+        if (typeof WasmCache !== 'undefined') {
+            self.Module.instantiateWasm = function (imports, receiveInstance) {
+                WasmCache.instantiate(loaded.replace(/\.js$/, '.wasm'), imports).then(
+                    r => receiveInstance(r.instance, r.module), reject);
+                return {};
+            };
+        }
+        for (const src of scripts) {
+            try {
+                loaded = src;
+                importScripts(src);
+                return;
+            } catch (e) {
+                loaded = null;
+            }
+        }
+        reject(new Error("No engine script could be loaded: " + scripts.join(', ')));
+    });
+    return moduleReady;
+}
+
+// ResultRingInfo is { base, capacity, head, records } as int32s
+function resultRingInfo() {
+    if (ringInfo < 0) {
+        const fn = Module['_' + prefix + 'getResultRing'];
+        ringInfo = (typeof fn === 'function' && Module.HEAPU8) ? fn() >> 2 : 0;
+    }
+    return ringInfo;
+}
+
+// Ring records carry their length; anything else is scanned for its NUL
+function readString(ptr) {
+    if (!ptr) return '';
+    const heap = Module.HEAPU8;
+    const base = ringInfo > 0 ? Module.HEAP32[ringInfo] : 0;
+    let end;
+    if (ringInfo > 0 && ptr >= base + 8 && ptr < base + Module.HEAP32[ringInfo + 1]) {
+        end = ptr + Module.HEAP32[(ptr >> 2) - 1];
+    } else {
+        end = heap.indexOf(0, ptr);
+    }
+    // TextDecoder rejects views of shared memory (the pthreads build), so copy those
+    const bytes = heap.subarray(ptr, end);
+    return decoder.decode(heap.buffer instanceof ArrayBuffer ? bytes : bytes.slice());
+}
+
+function callExport(name, returnType, argTypes, args) {
+    const allocations = [];
+    const types = argTypes.map(t => (t === 'int32array' ? 'number' : t));
+    const values = args.map((a, i) => {
+        if (argTypes[i] !== 'int32array') return a;
+        const ptr = Module._malloc(Math.max(4, a.byteLength));
+        Module.HEAP32.set(a, ptr >> 2);
+        allocations.push(ptr);
+        return ptr;
+    });
+    try {
+        if (returnType === 'string' && resultRingInfo()) {
+            return readString(Module.ccall(name, 'number', types, values));
+        }
+        return Module.ccall(name, returnType, types, values);
+    } finally {
+        allocations.forEach(p => Module._free(p));
+    }
+}
+
+function readExport(bufferFn, length) {
+    const ptr = Module.ccall(bufferFn, 'number', [], []);
+    if (!ptr || length <= 0) return new Int32Array(0);
+    return Module.HEAP32.slice(ptr >> 2, (ptr >> 2) + length);
+}
+
+self.onmessage = async function (e) {
+    const msg = e.data;
+    try {
+        if (msg.op === 'boot') {
+            await bootModule(msg.scripts, msg.prefix);
+            self.postMessage({ id: msg.id, result: true });
+            return;
+        }
+
+        await moduleReady;
+        if (msg.op === 'call') {
+            const result = callExport(msg.name, msg.returnType, msg.argTypes, msg.args);
+            self.postMessage({ id: msg.id, result });
+        } else if (msg.op === 'read') {
+            const result = readExport(msg.bufferFn, msg.length);
+            self.postMessage({ id: msg.id, result }, [result.buffer]);
+        }
+    } catch (err) {
+        self.postMessage({ id: msg.id, error: String(err && err.message ? err.message : err) });
+    }
+};
@@ -0,0 +1,267 @@
+/**
+ * DATA_STRUCTURES_VISUALIZER // WASM ENGINE HOST
+ * Shared by all four visualizers. Hosts the Emscripten module either on the page
+ * ("direct" mode, the default) or inside a Web Worker ("worker" mode, opt-in with
+ * ?engine=worker) behind one promise-based API:
+ *
+ *   Engine.boot(scripts, onReady, prefix)            load module (first script that loads wins)
+ *   Engine.call(name, returnType, argTypes, args)    -> Promise<result>  (same shape as ccall)
+ *   Engine.readInt32(bufferFn, length)               -> Promise<Int32Array>
+ *   Engine.viewInt32(bufferFn, length)               -> Promise<Int32Array>  (no copy in direct mode)
+ *   Engine.renderStats(el)                           -> Promise  (getStats() counters into el)
+ *
+ * An argType of 'int32array' copies an Int32Array argument into WASM memory and
+ * passes its pointer (freed after the call). readInt32 calls the exported
+ * pointer-returning function bufferFn and copies 'length' ints out of HEAP32; in
+ * worker mode that copy comes back as a transferred ArrayBuffer. viewInt32 skips the
+ * copy in direct mode and returns a view onto HEAP32 itself; read it before the next
+ * call, since that call may change the data or grow (and detach) the memory. Worker
+ * mode has no shared heap, so there it is the same as readInt32.
+ * In worker mode long operations no longer block rendering and input.
+ *
+ * String results come back through the module's result ring (Common/ResultRing.h):
+ * the export returns a pointer into the ring and the length sits just before it,
+ * so the text is decoded in place with one TextDecoder call instead of ccall's
+ * byte-by-byte scan. Modules without getResultRing fall back to ccall's 'string'.
+ *
+ * The .wasm is compiled while it downloads through wasm-cache.js, so revisits
+ * reuse the browser's HTTP and compiled-code caches. With ?module=combined every
+ * page loads the single Combined/combined.js build instead of its own module; its
+ * exports carry the page's prefix (hash_, graph_, avl_, heap_), which Engine adds
+ * to every name.
+ * ?build=o3 or ?build=oz loads the matching release build (Bench/release.js) instead,
+ * e.g. main.o3.js, falling back to the regular script when it is missing.
+ */
+
+const Engine = (function () {
+    const params = new URLSearchParams(window.location.search);
+    const mode = (params.get('engine') === 'worker' && typeof Worker !== 'undefined') ? 'worker' : 'direct';
+    // The worker script lives next to this file
+    const engineBase = document.currentScript ? document.currentScript.src : window.location.href;
+    const combined = params.get('module') === 'combined';
+    const COMBINED_SCRIPT = new URL('Combined/combined.js', engineBase).href;
+    const build = (params.get('build') || '').replace(/[^a-z0-9]/gi, '');
+
+    let ready = false;
+    let worker = null;
+    let nextId = 1;
+    const pending = new Map();
+    // Export name prefix; only set when running on the combined module
+    let prefix = '';
+    // HEAP32 index of the module's ResultRingInfo, 0 if it has none
+    let ringInfo = -1;
+
+    // --- Direct mode: run against the page's global Module ---
+
+    const decoder = new TextDecoder('utf-8');
+
+    // ResultRingInfo is { base, capacity, head, records } as int32s
+    function resultRingInfo() {
+        if (ringInfo < 0) {
+            const fn = Module['_' + prefix + 'getResultRing'];
+            ringInfo = (typeof fn === 'function' && Module.HEAPU8) ? fn() >> 2 : 0;
+        }
+        return ringInfo;
+    }
+
+    // Decodes a string export's result in place. Ring records carry their length;
+    // anything else (a module built without the ring) is scanned for its NUL.
+    function readString(ptr) {
+        if (!ptr) return '';
+        const heap = Module.HEAPU8;
+        const info = ringInfo;
+        let end;
+        if (info > 0 && ptr >= Module.HEAP32[info] + 8 && ptr < Module.HEAP32[info] + Module.HEAP32[info + 1]) {
+            end = ptr + Module.HEAP32[(ptr >> 2) - 1];
+        } else {
+            end = heap.indexOf(0, ptr);
+        }
+        // TextDecoder rejects views of shared memory (the pthreads build), so copy those
+        const bytes = heap.subarray(ptr, end);
+        return decoder.decode(heap.buffer instanceof ArrayBuffer ? bytes : bytes.slice());
+    }
+
+    function directCall(name, returnType, argTypes, args) {
+        const allocations = [];
+        const types = argTypes.map(t => (t === 'int32array' ? 'number' : t));
+        const values = args.map((a, i) => {
+            if (argTypes[i] !== 'int32array') return a;
+            const ptr = Module._malloc(Math.max(4, a.byteLength));
+            Module.HEAP32.set(a, ptr >> 2);
+            allocations.push(ptr);
+            return ptr;
+        });
+        try {
+            if (returnType === 'string' && resultRingInfo()) {
+                return readString(Module.ccall(name, 'number', types, values));
+            }
+            return Module.ccall(name, returnType, types, values);
+        } finally {
+            allocations.forEach(p => Module._free(p));
+        }
+    }
+
+    function directRead(bufferFn, length) {
+        const ptr = Module.ccall(bufferFn, 'number', [], []);
+        if (!ptr || length <= 0) return new Int32Array(0);
+        return Module.HEAP32.slice(ptr >> 2, (ptr >> 2) + length);
+    }
+
+    function directView(bufferFn, length) {
+        const ptr = Module.ccall(bufferFn, 'number', [], []);
+        if (!ptr || length <= 0) return new Int32Array(0);
+        return Module.HEAP32.subarray(ptr >> 2, (ptr >> 2) + length);
+    }
+
+    function loadScript(src, onError, onLoad) {
+        const s = document.createElement('script');
+        s.src = src;
+        s.onerror = onError;
+        if (onLoad) s.onload = onLoad;
+        document.body.appendChild(s);
+    }
+
+    // --- Worker mode: post messages to engine-worker.js ---
+
+    function post(message) {
+        return new Promise((resolve, reject) => {
+            const id = nextId++;
+            pending.set(id, { resolve, reject });
+            message.id = id;
+            const transfer = [];
+            (message.args || []).forEach(a => { if (a instanceof Int32Array) transfer.push(a.buffer); });
+            worker.postMessage(message, transfer);
+        });
+    }
+
+    function onWorkerMessage(e) {
+        const msg = e.data;
+        const entry = pending.get(msg.id);
+        if (!entry) return;
+        pending.delete(msg.id);
+        if (msg.error) entry.reject(new Error(msg.error));
+        else entry.resolve(msg.result);
+    }
+
+    // --- Public API ---
+
+    function boot(scripts, onReady, namePrefix) {
+        let candidates = Array.isArray(scripts) ? scripts : [scripts];
+        if (combined) {
+            candidates = [COMBINED_SCRIPT];
+            prefix = namePrefix || '';
+        }
+        if (build) {
+            candidates = candidates.flatMap(s => [s.replace(/\.js$/, '.' + build + '.js'), s]);
+        }
+        const markReady = () => {
+            ready = true;
+            if (typeof onReady === 'function') onReady();
+        };
+
+        if (mode === 'worker') {
+            // Module URLs are resolved against the page, the worker against engine.js
+            worker = new Worker(new URL('engine-worker.js', engineBase));
+            worker.onmessage = onWorkerMessage;
+            post({
+                op: 'boot',
+                scripts: candidates.map(s => new URL(s, window.location.href).href),
+                prefix
+            }).then(markReady, err => console.error("Engine worker failed to start:", err));
+            return;
+        }
+
+        // Direct mode: chain the page's Module hook, then try each script in turn
+        window.Module = window.Module || {};
+        const previous = Module.onRuntimeInitialized;
+        Module.onRuntimeInitialized = function () {
+            if (typeof previous === 'function') previous();
+            markReady();
+        };
+        let wasmUrl = null;
+        let i = 0;
+        const next = () => {
+            if (i >= candidates.length) return;
+            const src = candidates[i++];
+            wasmUrl = new URL(src.replace(/\.js$/, '.wasm'), window.location.href).href;
+            loadScript(src, next);
+        };
+        // Without wasm-cache.js the glue script fetches and compiles the .wasm itself
+        loadScript(new URL('wasm-cache.js', engineBase).href, next, () => {
+            Module.instantiateWasm = function (imports, receiveInstance) {
+                WasmCache.instantiate(wasmUrl, imports).then(
+                    r => receiveInstance(r.instance, r.module),
+                    err => console.error("WASM instantiation failed:", err));
+                return {};
+            };
+            next();
+        });
+    }
+
+    function call(name, returnType, argTypes, args) {
+        argTypes = argTypes || [];
+        args = args || [];
+        name = prefix + name;
+        if (mode === 'worker') {
+            return post({ op: 'call', name, returnType, argTypes, args });
+        }
+        try {
+            return Promise.resolve(directCall(name, returnType, argTypes, args));
+        } catch (e) {
+            return Promise.reject(e);
+        }
+    }
+
+    function readInt32(bufferFn, length) {
+        bufferFn = prefix + bufferFn;
+        if (mode === 'worker') {
+            return post({ op: 'read', bufferFn, length });
+        }
+        try {
+            return Promise.resolve(directRead(bufferFn, length));
+        } catch (e) {
+            return Promise.reject(e);
+        }
+    }
+
+    function viewInt32(bufferFn, length) {
+        if (mode === 'worker') {
+            return readInt32(bufferFn, length);
+        }
+        bufferFn = prefix + bufferFn;
+        try {
+            return Promise.resolve(directView(bufferFn, length));
+        } catch (e) {
+            return Promise.reject(e);
+        }
+    }
+
+    // Non-zero counters and the last export's duration from the C++ getStats() export
+    async function renderStats(el) {
+        if (!el) return;
+        try {
+            const s = JSON.parse(await call('getStats', 'string', [], []));
+            if (!s.enabled) {
+                el.innerText = "Instrumentation compiled out (ENGINE_STATS=0).";
+                return;
+            }
+            const rows = Object.keys(s)
+                .filter(k => k !== 'enabled' && k !== 'totalMs' && k !== 'lastMs' && s[k] !== 0)
+                .map(k => `${k}: ${s[k].toLocaleString()}`);
+            rows.push(`last call: ${s.lastMs.toFixed(3)} ms (total ${s.totalMs.toFixed(1)} ms)`);
+            el.innerHTML = rows.join('<br>');
+        } catch (e) {
+            el.innerText = "getStats() is not in this build.";
+        }
+    }
+
+    return {
+        mode,
+        boot,
+        call,
+        readInt32,
+        viewInt32,
+        renderStats,
+        isReady: () => ready
+    };
+})();
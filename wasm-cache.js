@@ -0,0 +1,35 @@
+/**
+ * DATA_STRUCTURES_VISUALIZER // WASM STREAMING INSTANTIATION
+ * Compiles .wasm files while they download and instantiates them in one step.
+ * Loaded by engine.js on the page and by engine-worker.js, both of which hook it
+ * into Emscripten through Module.instantiateWasm:
+ *
+ *   WasmCache.instantiate(url, imports)   -> Promise<{ instance, module }>
+ *
+ * There is no cache of our own: browsers refuse to store a WebAssembly.Module in
+ * IndexedDB, so the only reuse across visits is the browser's. A revisit gets the
+ * .wasm from the HTTP cache (revalidated by ETag / Last-Modified like any other
+ * file), and Chromium-based browsers also keep the compiled code of modules that
+ * came through compileStreaming / instantiateStreaming, so a warm start usually
+ * skips most of the compile. Streaming needs the server to send application/wasm;
+ * otherwise the response is read into memory and compiled from the bytes.
+ */
+
+const WasmCache = (function () {
+    async function instantiate(url, imports) {
+        const response = await fetch(url, { credentials: 'same-origin' });
+        if (!response.ok) throw new Error("Failed to fetch " + url + ": " + response.status);
+
+        if (WebAssembly.instantiateStreaming) {
+            try {
+                // instantiateStreaming consumes the body, so keep a copy for the fallback
+                return await WebAssembly.instantiateStreaming(response.clone(), imports);
+            } catch (e) {
+                // Usually a server that does not send application/wasm
+            }
+        }
+        return WebAssembly.instantiate(await response.arrayBuffer(), imports);
+    }
+
+    return { instantiate };
+})();